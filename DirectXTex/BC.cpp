@@ -26,10 +26,88 @@ namespace
     // Constants
     //-------------------------------------------------------------------------------------
 
+    // Rounding StoreScanline applies when writing 8-bit UNORM formats
+    const XMVECTORF32 g_8BitBias = { { { 0.5f / 255.f, 0.5f / 255.f, 0.5f / 255.f, 0.5f / 255.f } } };
+
     // Perceptual weightings for the importance of each channel.
     const HDRColorA g_Luminance(0.2125f / 0.7154f, 1.0f, 0.0721f / 0.7154f, 1.0f);
     const HDRColorA g_LuminanceInv(0.7154f / 0.2125f, 1.0f, 0.7154f / 0.0721f, 1.0f);
 
+    // Single color tables: for each 8-bit value, the pair of 5-bit (6-bit) endpoints whose
+    // 1/3 interpolant is closest to it. The 3% interpolation tolerance D3D allows is added
+    // to the error, so the tables prefer endpoints which are close together.
+    constexpr uint8_t g_aMatch5[256][2] =
+    {
+        {  0,  0 }, {  0,  0 }, {  0,  1 }, {  0,  1 }, {  0,  1 }, {  1,  0 }, {  1,  0 }, {  1,  1 },
+        {  1,  1 }, {  1,  1 }, {  1,  2 }, {  1,  2 }, {  1,  2 }, {  2,  1 }, {  2,  1 }, {  2,  2 },
+        {  2,  2 }, {  2,  2 }, {  2,  3 }, {  2,  3 }, {  2,  3 }, {  3,  2 }, {  3,  2 }, {  3,  2 },
+        {  3,  3 }, {  3,  3 }, {  3,  3 }, {  3,  4 }, {  3,  4 }, {  4,  3 }, {  4,  3 }, {  4,  3 },
+        {  4,  4 }, {  4,  4 }, {  4,  4 }, {  4,  5 }, {  4,  5 }, {  4,  5 }, {  5,  4 }, {  5,  4 },
+        {  5,  5 }, {  5,  5 }, {  5,  5 }, {  5,  6 }, {  5,  6 }, {  5,  6 }, {  6,  5 }, {  6,  5 },
+        {  6,  6 }, {  6,  6 }, {  6,  6 }, {  6,  7 }, {  6,  7 }, {  6,  7 }, {  7,  6 }, {  7,  6 },
+        {  7,  6 }, {  7,  7 }, {  7,  7 }, {  7,  7 }, {  7,  8 }, {  7,  8 }, {  8,  7 }, {  8,  7 },
+        {  8,  7 }, {  8,  8 }, {  8,  8 }, {  8,  8 }, {  8,  9 }, {  8,  9 }, {  9,  8 }, {  9,  8 },
+        {  9,  8 }, {  9,  9 }, {  9,  9 }, {  9,  9 }, {  9, 10 }, {  9, 10 }, {  9, 10 }, { 10,  9 },
+        { 10,  9 }, { 10, 10 }, { 10, 10 }, { 10, 10 }, { 10, 11 }, { 10, 11 }, { 10, 11 }, { 11, 10 },
+        { 11, 10 }, { 11, 11 }, { 11, 11 }, { 11, 11 }, { 11, 12 }, { 11, 12 }, { 11, 12 }, { 12, 11 },
+        { 12, 11 }, { 12, 11 }, { 12, 12 }, { 12, 12 }, { 12, 12 }, { 12, 13 }, { 12, 13 }, { 13, 12 },
+        { 13, 12 }, { 13, 12 }, { 13, 13 }, { 13, 13 }, { 13, 13 }, { 13, 14 }, { 13, 14 }, { 13, 14 },
+        { 14, 13 }, { 14, 13 }, { 14, 14 }, { 14, 14 }, { 14, 14 }, { 14, 15 }, { 14, 15 }, { 14, 15 },
+        { 15, 14 }, { 15, 14 }, { 15, 15 }, { 15, 15 }, { 15, 15 }, { 15, 16 }, { 15, 16 }, { 15, 16 },
+        { 16, 15 }, { 16, 15 }, { 16, 15 }, { 16, 16 }, { 16, 16 }, { 16, 16 }, { 16, 17 }, { 16, 17 },
+        { 17, 16 }, { 17, 16 }, { 17, 16 }, { 17, 17 }, { 17, 17 }, { 17, 17 }, { 17, 18 }, { 17, 18 },
+        { 18, 17 }, { 18, 17 }, { 18, 17 }, { 18, 18 }, { 18, 18 }, { 18, 18 }, { 18, 19 }, { 18, 19 },
+        { 18, 19 }, { 19, 18 }, { 19, 18 }, { 19, 19 }, { 19, 19 }, { 19, 19 }, { 19, 20 }, { 19, 20 },
+        { 19, 20 }, { 20, 19 }, { 20, 19 }, { 20, 19 }, { 20, 20 }, { 20, 20 }, { 20, 20 }, { 20, 21 },
+        { 20, 21 }, { 21, 20 }, { 21, 20 }, { 21, 20 }, { 21, 21 }, { 21, 21 }, { 21, 21 }, { 21, 22 },
+        { 21, 22 }, { 22, 21 }, { 22, 21 }, { 22, 21 }, { 22, 22 }, { 22, 22 }, { 22, 22 }, { 22, 23 },
+        { 22, 23 }, { 22, 23 }, { 23, 22 }, { 23, 22 }, { 23, 23 }, { 23, 23 }, { 23, 23 }, { 23, 24 },
+        { 23, 24 }, { 23, 24 }, { 24, 23 }, { 24, 23 }, { 24, 24 }, { 24, 24 }, { 24, 24 }, { 24, 25 },
+        { 24, 25 }, { 24, 25 }, { 25, 24 }, { 25, 24 }, { 25, 24 }, { 25, 25 }, { 25, 25 }, { 25, 25 },
+        { 25, 26 }, { 25, 26 }, { 26, 25 }, { 26, 25 }, { 26, 25 }, { 26, 26 }, { 26, 26 }, { 26, 26 },
+        { 26, 27 }, { 26, 27 }, { 27, 26 }, { 27, 26 }, { 27, 26 }, { 27, 27 }, { 27, 27 }, { 27, 27 },
+        { 27, 28 }, { 27, 28 }, { 27, 28 }, { 28, 27 }, { 28, 27 }, { 28, 28 }, { 28, 28 }, { 28, 28 },
+        { 28, 29 }, { 28, 29 }, { 28, 29 }, { 29, 28 }, { 29, 28 }, { 29, 28 }, { 29, 29 }, { 29, 29 },
+        { 29, 29 }, { 29, 30 }, { 29, 30 }, { 30, 29 }, { 30, 29 }, { 30, 29 }, { 30, 30 }, { 30, 30 },
+        { 30, 30 }, { 30, 31 }, { 30, 31 }, { 31, 30 }, { 31, 30 }, { 31, 30 }, { 31, 31 }, { 31, 31 }
+    };
+
+    constexpr uint8_t g_aMatch6[256][2] =
+    {
+        {  0,  0 }, {  0,  1 }, {  0,  1 }, {  1,  0 }, {  1,  1 }, {  1,  2 }, {  1,  2 }, {  2,  1 },
+        {  2,  2 }, {  2,  3 }, {  2,  3 }, {  3,  2 }, {  3,  3 }, {  3,  4 }, {  3,  4 }, {  4,  3 },
+        {  4,  4 }, {  4,  5 }, {  4,  5 }, {  5,  4 }, {  5,  5 }, {  5,  6 }, {  5,  6 }, {  6,  5 },
+        {  6,  6 }, {  6,  6 }, {  6,  7 }, {  7,  6 }, {  7,  7 }, {  7,  7 }, {  7,  8 }, {  8,  7 },
+        {  8,  8 }, {  8,  8 }, {  8,  9 }, {  9,  8 }, {  9,  9 }, {  9,  9 }, {  9, 10 }, { 10,  9 },
+        { 10, 10 }, { 10, 10 }, { 10, 11 }, { 11, 10 }, { 11, 11 }, { 11, 11 }, { 11, 12 }, { 12, 11 },
+        { 12, 12 }, { 12, 12 }, { 12, 13 }, { 13, 12 }, { 13, 13 }, { 13, 13 }, { 13, 14 }, { 14, 13 },
+        { 14, 14 }, { 14, 14 }, { 14, 15 }, { 15, 14 }, { 15, 15 }, { 15, 15 }, { 15, 16 }, { 16, 15 },
+        { 16, 15 }, { 16, 16 }, { 16, 17 }, { 17, 16 }, { 17, 16 }, { 17, 17 }, { 17, 18 }, { 18, 17 },
+        { 18, 17 }, { 18, 18 }, { 18, 19 }, { 19, 18 }, { 19, 18 }, { 19, 19 }, { 19, 20 }, { 20, 19 },
+        { 20, 19 }, { 20, 20 }, { 20, 21 }, { 21, 20 }, { 21, 20 }, { 21, 21 }, { 21, 22 }, { 21, 22 },
+        { 22, 21 }, { 22, 22 }, { 22, 23 }, { 22, 23 }, { 23, 22 }, { 23, 23 }, { 23, 24 }, { 23, 24 },
+        { 24, 23 }, { 24, 24 }, { 24, 25 }, { 24, 25 }, { 25, 24 }, { 25, 25 }, { 25, 26 }, { 25, 26 },
+        { 26, 25 }, { 26, 26 }, { 26, 27 }, { 26, 27 }, { 27, 26 }, { 27, 27 }, { 27, 27 }, { 27, 28 },
+        { 28, 27 }, { 28, 28 }, { 28, 28 }, { 28, 29 }, { 29, 28 }, { 29, 29 }, { 29, 29 }, { 29, 30 },
+        { 30, 29 }, { 30, 30 }, { 30, 30 }, { 30, 31 }, { 31, 30 }, { 31, 31 }, { 31, 31 }, { 31, 32 },
+        { 32, 31 }, { 32, 32 }, { 32, 32 }, { 32, 33 }, { 33, 32 }, { 33, 33 }, { 33, 33 }, { 33, 34 },
+        { 34, 33 }, { 34, 34 }, { 34, 34 }, { 34, 35 }, { 35, 34 }, { 35, 35 }, { 35, 35 }, { 35, 36 },
+        { 36, 35 }, { 36, 36 }, { 36, 36 }, { 36, 37 }, { 37, 36 }, { 37, 36 }, { 37, 37 }, { 37, 38 },
+        { 38, 37 }, { 38, 37 }, { 38, 38 }, { 38, 39 }, { 39, 38 }, { 39, 38 }, { 39, 39 }, { 39, 40 },
+        { 40, 39 }, { 40, 39 }, { 40, 40 }, { 40, 41 }, { 41, 40 }, { 41, 40 }, { 41, 41 }, { 41, 42 },
+        { 42, 41 }, { 42, 41 }, { 42, 42 }, { 42, 43 }, { 42, 43 }, { 43, 42 }, { 43, 43 }, { 43, 44 },
+        { 43, 44 }, { 44, 43 }, { 44, 44 }, { 44, 45 }, { 44, 45 }, { 45, 44 }, { 45, 45 }, { 45, 46 },
+        { 45, 46 }, { 46, 45 }, { 46, 46 }, { 46, 47 }, { 46, 47 }, { 47, 46 }, { 47, 47 }, { 47, 48 },
+        { 47, 48 }, { 48, 47 }, { 48, 48 }, { 48, 48 }, { 48, 49 }, { 49, 48 }, { 49, 49 }, { 49, 49 },
+        { 49, 50 }, { 50, 49 }, { 50, 50 }, { 50, 50 }, { 50, 51 }, { 51, 50 }, { 51, 51 }, { 51, 51 },
+        { 51, 52 }, { 52, 51 }, { 52, 52 }, { 52, 52 }, { 52, 53 }, { 53, 52 }, { 53, 53 }, { 53, 53 },
+        { 53, 54 }, { 54, 53 }, { 54, 54 }, { 54, 54 }, { 54, 55 }, { 55, 54 }, { 55, 55 }, { 55, 55 },
+        { 55, 56 }, { 56, 55 }, { 56, 56 }, { 56, 56 }, { 56, 57 }, { 57, 56 }, { 57, 57 }, { 57, 57 },
+        { 57, 58 }, { 58, 57 }, { 58, 57 }, { 58, 58 }, { 58, 59 }, { 59, 58 }, { 59, 58 }, { 59, 59 },
+        { 59, 60 }, { 60, 59 }, { 60, 59 }, { 60, 60 }, { 60, 61 }, { 61, 60 }, { 61, 60 }, { 61, 61 },
+        { 61, 62 }, { 62, 61 }, { 62, 61 }, { 62, 62 }, { 62, 63 }, { 63, 62 }, { 63, 62 }, { 63, 63 }
+    };
+
     //-------------------------------------------------------------------------------------
     // Decode/Encode RGB 5/6/5 colors
     //-------------------------------------------------------------------------------------
@@ -194,8 +272,8 @@ namespace
         }
 
 
-        // Two color block.. no need to root-find
-        if (fAB < 1.0f / 4096.0f)
+        // Two color block (or range-fit only).. no need to root-find
+        if ((fAB < 1.0f / 4096.0f) || (flags & BC_FLAGS_EFFORT_FAST))
         {
             pX->r = X.r; pX->g = X.g; pX->b = X.b; pX->a = 1.0f;
             pY->r = Y.r; pY->g = Y.g; pY->b = Y.b; pY->a = 1.0f;
@@ -314,13 +392,266 @@ namespace
     }
 
 
+#ifndef COLOR_WEIGHTS
     //-------------------------------------------------------------------------------------
-    inline void DecodeBC1(
-        _Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR *pColor,
+    // Structure-of-arrays version of OptimizeRGB for four-color blocks. Each vector lane
+    // holds a different block, and the arithmetic is performed in the same order as the
+    // scalar version so each lane finds the same endpoints.
+    //-------------------------------------------------------------------------------------
+    void OptimizeRGBBatch(
+        _Out_writes_(3) XMVECTOR *pX,
+        _Out_writes_(3) XMVECTOR *pY,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pR,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pG,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pB,
+        uint32_t flags) noexcept
+    {
+        constexpr float fEpsilon = (0.25f / 64.0f) * (0.25f / 64.0f);
+        static const float pC4[] = { 3.0f / 3.0f, 2.0f / 3.0f, 1.0f / 3.0f, 0.0f / 3.0f };
+        static const float pD4[] = { 0.0f / 3.0f, 1.0f / 3.0f, 2.0f / 3.0f, 3.0f / 3.0f };
+
+        const XMVECTOR vEpsilon = XMVectorReplicate(fEpsilon);
+        const XMVECTOR vTwoColor = XMVectorReplicate(1.0f / 4096.0f);
+        const XMVECTOR vTwo = XMVectorReplicate(2.0f);
+        const XMVECTOR vSteps = XMVectorReplicate(3.0f);
+        const XMVECTOR vEighth = XMVectorReplicate(1.0f / 8.0f);
+        const XMVECTOR vZero = XMVectorZero();
+
+        // Find Min and Max points, as starting point
+        XMVECTOR Xr, Xg, Xb;
+        if (flags & BC_FLAGS_UNIFORM)
+        {
+            Xr = Xg = Xb = g_XMOne;
+        }
+        else
+        {
+            Xr = XMVectorReplicate(g_Luminance.r);
+            Xg = XMVectorReplicate(g_Luminance.g);
+            Xb = XMVectorReplicate(g_Luminance.b);
+        }
+
+        XMVECTOR Yr = vZero;
+        XMVECTOR Yg = vZero;
+        XMVECTOR Yb = vZero;
+
+        for (size_t iPoint = 0; iPoint < NUM_PIXELS_PER_BLOCK; iPoint++)
+        {
+            Xr = XMVectorMin(pR[iPoint], Xr);
+            Xg = XMVectorMin(pG[iPoint], Xg);
+            Xb = XMVectorMin(pB[iPoint], Xb);
+
+            Yr = XMVectorMax(pR[iPoint], Yr);
+            Yg = XMVectorMax(pG[iPoint], Yg);
+            Yb = XMVectorMax(pB[iPoint], Yb);
+        }
+
+        // Diagonal axis
+        const XMVECTOR ABr = XMVectorSubtract(Yr, Xr);
+        const XMVECTOR ABg = XMVectorSubtract(Yg, Xg);
+        const XMVECTOR ABb = XMVectorSubtract(Yb, Xb);
+
+        const XMVECTOR fAB = XMVectorAdd(XMVectorAdd(XMVectorMultiply(ABr, ABr), XMVectorMultiply(ABg, ABg)), XMVectorMultiply(ABb, ABb));
+
+        // Single color blocks.. no need to root-find
+        const XMVECTOR bMultiColor = XMVectorGreaterOrEqual(fAB, XMVectorReplicate(FLT_MIN));
+        if (XMVector4EqualInt(bMultiColor, XMVectorFalseInt()))
+        {
+            pX[0] = Xr; pX[1] = Xg; pX[2] = Xb;
+            pY[0] = Yr; pY[1] = Yg; pY[2] = Yb;
+            return;
+        }
+
+        // Try all four axis directions, to determine which diagonal best fits data
+        const XMVECTOR fABInv = XMVectorDivide(g_XMOne, fAB);
+
+        XMVECTOR Dirr = XMVectorMultiply(ABr, fABInv);
+        XMVECTOR Dirg = XMVectorMultiply(ABg, fABInv);
+        XMVECTOR Dirb = XMVectorMultiply(ABb, fABInv);
+
+        const XMVECTOR Midr = XMVectorMultiply(XMVectorAdd(Xr, Yr), g_XMOneHalf);
+        const XMVECTOR Midg = XMVectorMultiply(XMVectorAdd(Xg, Yg), g_XMOneHalf);
+        const XMVECTOR Midb = XMVectorMultiply(XMVectorAdd(Xb, Yb), g_XMOneHalf);
+
+        XMVECTOR fDir[4] = { vZero, vZero, vZero, vZero };
+
+        for (size_t iPoint = 0; iPoint < NUM_PIXELS_PER_BLOCK; iPoint++)
+        {
+            const XMVECTOR Ptr = XMVectorMultiply(XMVectorSubtract(pR[iPoint], Midr), Dirr);
+            const XMVECTOR Ptg = XMVectorMultiply(XMVectorSubtract(pG[iPoint], Midg), Dirg);
+            const XMVECTOR Ptb = XMVectorMultiply(XMVectorSubtract(pB[iPoint], Midb), Dirb);
+
+            const XMVECTOR RPlusG = XMVectorAdd(Ptr, Ptg);
+            const XMVECTOR RMinusG = XMVectorSubtract(Ptr, Ptg);
+
+            XMVECTOR f;
+
+            f = XMVectorAdd(RPlusG, Ptb);
+            fDir[0] = XMVectorAdd(fDir[0], XMVectorMultiply(f, f));
+
+            f = XMVectorSubtract(RPlusG, Ptb);
+            fDir[1] = XMVectorAdd(fDir[1], XMVectorMultiply(f, f));
+
+            f = XMVectorAdd(RMinusG, Ptb);
+            fDir[2] = XMVectorAdd(fDir[2], XMVectorMultiply(f, f));
+
+            f = XMVectorSubtract(RMinusG, Ptb);
+            fDir[3] = XMVectorAdd(fDir[3], XMVectorMultiply(f, f));
+        }
+
+        // Track bit 1 (swap green) and bit 0 (swap blue) of the winning direction per lane
+        XMVECTOR fDirMax = fDir[0];
+        XMVECTOR bSwapG = XMVectorFalseInt();
+        XMVECTOR bSwapB = XMVectorFalseInt();
+
+        XMVECTOR bBetter = XMVectorGreater(fDir[1], fDirMax);
+        fDirMax = XMVectorSelect(fDirMax, fDir[1], bBetter);
+        bSwapB = bBetter;
+
+        bBetter = XMVectorGreater(fDir[2], fDirMax);
+        fDirMax = XMVectorSelect(fDirMax, fDir[2], bBetter);
+        bSwapG = bBetter;
+        bSwapB = XMVectorAndCInt(bSwapB, bBetter);
+
+        bBetter = XMVectorGreater(fDir[3], fDirMax);
+        bSwapG = XMVectorOrInt(bSwapG, bBetter);
+        bSwapB = XMVectorOrInt(bSwapB, bBetter);
+
+        bSwapG = XMVectorAndInt(bSwapG, bMultiColor);
+        bSwapB = XMVectorAndInt(bSwapB, bMultiColor);
+
+        XMVECTOR f = Xg;
+        Xg = XMVectorSelect(Xg, Yg, bSwapG);
+        Yg = XMVectorSelect(Yg, f, bSwapG);
+
+        f = Xb;
+        Xb = XMVectorSelect(Xb, Yb, bSwapB);
+        Yb = XMVectorSelect(Yb, f, bSwapB);
+
+        // Two color blocks (or range-fit only).. no need to root-find
+        XMVECTOR bActive = (flags & BC_FLAGS_EFFORT_FAST)
+            ? XMVectorFalseInt()
+            : XMVectorAndInt(bMultiColor, XMVectorGreaterOrEqual(fAB, vTwoColor));
+
+        // Use Newton's Method to find local minima of sum-of-squares error, with lanes
+        // dropping out as they converge.
+        for (size_t iIteration = 0; iIteration < 8; iIteration++)
+        {
+            if (XMVector4EqualInt(bActive, XMVectorFalseInt()))
+                break;
+
+            // Calculate new steps
+            XMVECTOR pStepsR[4], pStepsG[4], pStepsB[4];
+
+            for (size_t iStep = 0; iStep < 4; iStep++)
+            {
+                pStepsR[iStep] = XMVectorAdd(XMVectorScale(Xr, pC4[iStep]), XMVectorScale(Yr, pD4[iStep]));
+                pStepsG[iStep] = XMVectorAdd(XMVectorScale(Xg, pC4[iStep]), XMVectorScale(Yg, pD4[iStep]));
+                pStepsB[iStep] = XMVectorAdd(XMVectorScale(Xb, pC4[iStep]), XMVectorScale(Yb, pD4[iStep]));
+            }
+
+            // Calculate color direction
+            Dirr = XMVectorSubtract(Yr, Xr);
+            Dirg = XMVectorSubtract(Yg, Xg);
+            Dirb = XMVectorSubtract(Yb, Xb);
+
+            const XMVECTOR fLen = XMVectorAdd(XMVectorAdd(XMVectorMultiply(Dirr, Dirr), XMVectorMultiply(Dirg, Dirg)), XMVectorMultiply(Dirb, Dirb));
+
+            bActive = XMVectorAndInt(bActive, XMVectorGreaterOrEqual(fLen, vTwoColor));
+            if (XMVector4EqualInt(bActive, XMVectorFalseInt()))
+                break;
+
+            const XMVECTOR fScale = XMVectorDivide(vSteps, fLen);
+
+            Dirr = XMVectorMultiply(Dirr, fScale);
+            Dirg = XMVectorMultiply(Dirg, fScale);
+            Dirb = XMVectorMultiply(Dirb, fScale);
+
+            // Evaluate function, and derivatives
+            XMVECTOR d2X = vZero;
+            XMVECTOR d2Y = vZero;
+            XMVECTOR dXr = vZero, dXg = vZero, dXb = vZero;
+            XMVECTOR dYr = vZero, dYg = vZero, dYb = vZero;
+
+            for (size_t iPoint = 0; iPoint < NUM_PIXELS_PER_BLOCK; iPoint++)
+            {
+                const XMVECTOR fDot = XMVectorAdd(
+                    XMVectorAdd(
+                        XMVectorMultiply(XMVectorSubtract(pR[iPoint], Xr), Dirr),
+                        XMVectorMultiply(XMVectorSubtract(pG[iPoint], Xg), Dirg)),
+                    XMVectorMultiply(XMVectorSubtract(pB[iPoint], Xb), Dirb));
+
+                XMVECTOR iStep = XMVectorTruncate(XMVectorAdd(fDot, g_XMOneHalf));
+                iStep = XMVectorSelect(iStep, vZero, XMVectorLessOrEqual(fDot, vZero));
+                iStep = XMVectorSelect(iStep, vSteps, XMVectorGreaterOrEqual(fDot, vSteps));
+
+                const XMVECTOR bStep1 = XMVectorEqual(iStep, g_XMOne);
+                const XMVECTOR bStep2 = XMVectorEqual(iStep, vTwo);
+                const XMVECTOR bStep3 = XMVectorEqual(iStep, vSteps);
+
+                const XMVECTOR Stepr = XMVectorSelect(XMVectorSelect(XMVectorSelect(pStepsR[0], pStepsR[1], bStep1), pStepsR[2], bStep2), pStepsR[3], bStep3);
+                const XMVECTOR Stepg = XMVectorSelect(XMVectorSelect(XMVectorSelect(pStepsG[0], pStepsG[1], bStep1), pStepsG[2], bStep2), pStepsG[3], bStep3);
+                const XMVECTOR Stepb = XMVectorSelect(XMVectorSelect(XMVectorSelect(pStepsB[0], pStepsB[1], bStep1), pStepsB[2], bStep2), pStepsB[3], bStep3);
+
+                const XMVECTOR C = XMVectorSelect(XMVectorSelect(XMVectorSelect(
+                    XMVectorReplicate(pC4[0]), XMVectorReplicate(pC4[1]), bStep1), XMVectorReplicate(pC4[2]), bStep2), XMVectorReplicate(pC4[3]), bStep3);
+                const XMVECTOR D = XMVectorSelect(XMVectorSelect(XMVectorSelect(
+                    XMVectorReplicate(pD4[0]), XMVectorReplicate(pD4[1]), bStep1), XMVectorReplicate(pD4[2]), bStep2), XMVectorReplicate(pD4[3]), bStep3);
+
+                const XMVECTOR Diffr = XMVectorSubtract(Stepr, pR[iPoint]);
+                const XMVECTOR Diffg = XMVectorSubtract(Stepg, pG[iPoint]);
+                const XMVECTOR Diffb = XMVectorSubtract(Stepb, pB[iPoint]);
+
+                const XMVECTOR fC = XMVectorMultiply(C, vEighth);
+                const XMVECTOR fD = XMVectorMultiply(D, vEighth);
+
+                d2X = XMVectorAdd(d2X, XMVectorMultiply(fC, C));
+                dXr = XMVectorAdd(dXr, XMVectorMultiply(fC, Diffr));
+                dXg = XMVectorAdd(dXg, XMVectorMultiply(fC, Diffg));
+                dXb = XMVectorAdd(dXb, XMVectorMultiply(fC, Diffb));
+
+                d2Y = XMVectorAdd(d2Y, XMVectorMultiply(fD, D));
+                dYr = XMVectorAdd(dYr, XMVectorMultiply(fD, Diffr));
+                dYg = XMVectorAdd(dYg, XMVectorMultiply(fD, Diffg));
+                dYb = XMVectorAdd(dYb, XMVectorMultiply(fD, Diffb));
+            }
+
+            // Move endpoints
+            const XMVECTOR bMoveX = XMVectorAndInt(bActive, XMVectorGreater(d2X, vZero));
+            const XMVECTOR fX = XMVectorDivide(g_XMNegativeOne, d2X);
+
+            Xr = XMVectorSelect(Xr, XMVectorAdd(Xr, XMVectorMultiply(dXr, fX)), bMoveX);
+            Xg = XMVectorSelect(Xg, XMVectorAdd(Xg, XMVectorMultiply(dXg, fX)), bMoveX);
+            Xb = XMVectorSelect(Xb, XMVectorAdd(Xb, XMVectorMultiply(dXb, fX)), bMoveX);
+
+            const XMVECTOR bMoveY = XMVectorAndInt(bActive, XMVectorGreater(d2Y, vZero));
+            const XMVECTOR fY = XMVectorDivide(g_XMNegativeOne, d2Y);
+
+            Yr = XMVectorSelect(Yr, XMVectorAdd(Yr, XMVectorMultiply(dYr, fY)), bMoveY);
+            Yg = XMVectorSelect(Yg, XMVectorAdd(Yg, XMVectorMultiply(dYg, fY)), bMoveY);
+            Yb = XMVectorSelect(Yb, XMVectorAdd(Yb, XMVectorMultiply(dYb, fY)), bMoveY);
+
+            XMVECTOR bConverged = XMVectorAndInt(XMVectorLess(XMVectorMultiply(dXr, dXr), vEpsilon), XMVectorLess(XMVectorMultiply(dXg, dXg), vEpsilon));
+            bConverged = XMVectorAndInt(bConverged, XMVectorLess(XMVectorMultiply(dXb, dXb), vEpsilon));
+            bConverged = XMVectorAndInt(bConverged, XMVectorLess(XMVectorMultiply(dYr, dYr), vEpsilon));
+            bConverged = XMVectorAndInt(bConverged, XMVectorLess(XMVectorMultiply(dYg, dYg), vEpsilon));
+            bConverged = XMVectorAndInt(bConverged, XMVectorLess(XMVectorMultiply(dYb, dYb), vEpsilon));
+
+            bActive = XMVectorAndCInt(bActive, bConverged);
+        }
+
+        pX[0] = Xr; pX[1] = Xg; pX[2] = Xb;
+        pY[0] = Yr; pY[1] = Yg; pY[2] = Yb;
+    }
+#endif // !COLOR_WEIGHTS
+
+
+    //-------------------------------------------------------------------------------------
+    inline void DecodeBC1Palette(
+        _Out_writes_(4) XMVECTOR *pPalette,
         _In_ const D3DX_BC1 *pBC,
         bool isbc1) noexcept
     {
-        assert(pColor && pBC);
+        assert(pPalette && pBC);
         static_assert(sizeof(D3DX_BC1) == 8, "D3DX_BC1 should be 8 bytes");
 
         static XMVECTORF32 s_Scale = { { { 1.f / 31.f, 1.f / 63.f, 1.f / 31.f, 1.f } } };
@@ -349,20 +680,255 @@ namespace
             clr3 = XMVectorLerp(clr0, clr1, 2.f / 3.f);
         }
 
+        pPalette[0] = clr0;
+        pPalette[1] = clr1;
+        pPalette[2] = clr2;
+        pPalette[3] = clr3;
+    }
+
+    inline void DecodeBC1(
+        _Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR *pColor,
+        _In_ const D3DX_BC1 *pBC,
+        bool isbc1) noexcept
+    {
+        assert(pColor && pBC);
+
+        XMVECTOR aPalette[4];
+        DecodeBC1Palette(aPalette, pBC, isbc1);
+
+        uint32_t dw = pBC->bitmap;
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i, dw >>= 2)
+        {
+            pColor[i] = aPalette[dw & 3];
+        }
+    }
+
+    // Decodes the color part of a block straight to 8-bit RGBA. The four palette entries are converted
+    // the way StoreScanline writes DXGI_FORMAT_R8G8B8A8_UNORM, so the pixels match the XMVECTOR path.
+    inline void DecodeBC1(
+        _Out_writes_(NUM_PIXELS_PER_BLOCK) XMUBYTEN4 *pColor,
+        _In_ const D3DX_BC1 *pBC,
+        bool isbc1) noexcept
+    {
+        assert(pColor && pBC);
+
+        XMVECTOR aColors[4];
+        DecodeBC1Palette(aColors, pBC, isbc1);
+
+        XMUBYTEN4 aPalette[4];
+        for (size_t j = 0; j < 4; ++j)
+        {
+            XMStoreUByteN4(&aPalette[j], XMVectorAdd(aColors[j], g_8BitBias));
+        }
+
         uint32_t dw = pBC->bitmap;
 
         for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i, dw >>= 2)
         {
-            switch (dw & 3)
+            pColor[i] = aPalette[dw & 3];
+        }
+    }
+
+    // Builds the eight alpha values of a BC3 block in index order
+    inline void DecodeBC3AlphaPalette(
+        _Out_writes_(8) float *pAlpha,
+        _In_ const D3DX_BC3 *pBC) noexcept
+    {
+        assert(pAlpha && pBC);
+
+        pAlpha[0] = static_cast<float>(pBC->alpha[0]) * (1.0f / 255.0f);
+        pAlpha[1] = static_cast<float>(pBC->alpha[1]) * (1.0f / 255.0f);
+
+        if (pBC->alpha[0] > pBC->alpha[1])
+        {
+            for (size_t i = 1; i < 7; ++i)
+                pAlpha[i + 1] = (pAlpha[0] * float(7u - i) + pAlpha[1] * float(i)) * (1.0f / 7.0f);
+        }
+        else
+        {
+            for (size_t i = 1; i < 5; ++i)
+                pAlpha[i + 1] = (pAlpha[0] * float(5u - i) + pAlpha[1] * float(i)) * (1.0f / 5.0f);
+
+            pAlpha[6] = 0.0f;
+            pAlpha[7] = 1.0f;
+        }
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Builds the palette the decoder derives from a pair of 5:6:5 endpoints, in the
+    // weighted color space used by the encoder. Entries are in code order.
+    //-------------------------------------------------------------------------------------
+    void BuildPaletteBC1(
+        _Out_writes_(4) HDRColorA *pStep,
+        uint16_t wColor0,
+        uint16_t wColor1,
+        uint32_t uSteps,
+        uint32_t flags) noexcept
+    {
+        Decode565(&pStep[0], wColor0);
+        Decode565(&pStep[1], wColor1);
+
+        if (!(flags & BC_FLAGS_UNIFORM))
+        {
+            for (size_t iStep = 0; iStep < 2; ++iStep)
+            {
+                pStep[iStep].r *= g_Luminance.r;
+                pStep[iStep].g *= g_Luminance.g;
+                pStep[iStep].b *= g_Luminance.b;
+            }
+        }
+
+        if (3 == uSteps)
+        {
+            HDRColorALerp(&pStep[2], &pStep[0], &pStep[1], 0.5f);
+            pStep[3] = pStep[2];
+        }
+        else
+        {
+            HDRColorALerp(&pStep[2], &pStep[0], &pStep[1], 1.0f / 3.0f);
+            HDRColorALerp(&pStep[3], &pStep[0], &pStep[1], 2.0f / 3.0f);
+        }
+    }
+
+    inline uint32_t FindClosestBC1(
+        _In_ const HDRColorA *pClr,
+        _In_reads_(uSteps) const HDRColorA *pStep,
+        uint32_t uSteps,
+        _Out_opt_ float *pErr) noexcept
+    {
+        uint32_t iBest = 0;
+        float fBestErr = FLT_MAX;
+
+        for (uint32_t iStep = 0; iStep < uSteps; ++iStep)
+        {
+            const float r = pClr->r - pStep[iStep].r;
+            const float g = pClr->g - pStep[iStep].g;
+            const float b = pClr->b - pStep[iStep].b;
+
+            const float fErr = r * r + g * g + b * b;
+            if (fErr < fBestErr)
+            {
+                fBestErr = fErr;
+                iBest = iStep;
+            }
+        }
+
+        if (pErr)
+            *pErr = fBestErr;
+
+        return iBest;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Sum of squared errors of the block when every pixel picks its closest palette entry
+    //-------------------------------------------------------------------------------------
+    float ComputeErrorBC1(
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *pColor,
+        uint16_t wColorA,
+        uint16_t wColorB,
+        uint32_t uSteps,
+        float threshold,
+        uint32_t flags,
+        float fMaxErr) noexcept
+    {
+        HDRColorA Step[4];
+        BuildPaletteBC1(Step, wColorA, wColorB, uSteps, flags);
+
+        // In four-color mode equal endpoints encode as a solid block
+        const uint32_t cSteps = ((4 == uSteps) && (wColorA == wColorB)) ? 1u : uSteps;
+
+        float fTotalErr = 0.0f;
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            if ((3 == uSteps) && (pColor[i].a < threshold))
+                continue;
+
+            HDRColorA Clr;
+            if (flags & BC_FLAGS_UNIFORM)
+            {
+                Clr.r = pColor[i].r;
+                Clr.g = pColor[i].g;
+                Clr.b = pColor[i].b;
+            }
+            else
+            {
+                Clr.r = pColor[i].r * g_Luminance.r;
+                Clr.g = pColor[i].g * g_Luminance.g;
+                Clr.b = pColor[i].b * g_Luminance.b;
+            }
+            Clr.a = 1.0f;
+
+            float fErr;
+            FindClosestBC1(&Clr, Step, cSteps, &fErr);
+
+            fTotalErr += fErr;
+            if (fTotalErr >= fMaxErr)
+                break;
+        }
+
+        return fTotalErr;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Walks each 5:6:5 endpoint component up and down by one step for as long as that
+    // lowers the block error (used for BC_FLAGS_EFFORT_BEST)
+    //-------------------------------------------------------------------------------------
+    void RefineEndPointsBC1(
+        _Inout_ uint16_t *pwColorA,
+        _Inout_ uint16_t *pwColorB,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *pColor,
+        uint32_t uSteps,
+        float threshold,
+        uint32_t flags) noexcept
+    {
+        static const uint32_t s_Shift[] = { 11, 5, 0 };
+        static const uint32_t s_Mask[] = { 31, 63, 31 };
+
+        uint16_t wColor[2] = { *pwColorA, *pwColorB };
+        float fBestErr = ComputeErrorBC1(pColor, wColor[0], wColor[1], uSteps, threshold, flags, FLT_MAX);
+
+        for (size_t iPass = 0; (iPass < 8) && (fBestErr > 0.0f); ++iPass)
+        {
+            bool bImproved = false;
+
+            for (size_t iEndPoint = 0; iEndPoint < 2; ++iEndPoint)
             {
-            case 0: pColor[i] = clr0; break;
-            case 1: pColor[i] = clr1; break;
-            case 2: pColor[i] = clr2; break;
+                for (size_t iChannel = 0; iChannel < 3; ++iChannel)
+                {
+                    const uint32_t uValue = (uint32_t(wColor[iEndPoint]) >> s_Shift[iChannel]) & s_Mask[iChannel];
+
+                    for (int iDelta = -1; iDelta <= 1; iDelta += 2)
+                    {
+                        const int iNew = int(uValue) + iDelta;
+                        if (iNew < 0 || iNew > int(s_Mask[iChannel]))
+                            continue;
 
-            case 3:
-            default: pColor[i] = clr3; break;
+                        uint16_t wTry[2] = { wColor[0], wColor[1] };
+                        wTry[iEndPoint] = static_cast<uint16_t>((wTry[iEndPoint] & ~(s_Mask[iChannel] << s_Shift[iChannel]))
+                            | (uint32_t(iNew) << s_Shift[iChannel]));
+
+                        const float fErr = ComputeErrorBC1(pColor, wTry[0], wTry[1], uSteps, threshold, flags, fBestErr);
+                        if (fErr < fBestErr)
+                        {
+                            fBestErr = fErr;
+                            wColor[0] = wTry[0];
+                            wColor[1] = wTry[1];
+                            bImproved = true;
+                            break;
+                        }
+                    }
+                }
             }
+
+            if (!bImproved)
+                break;
         }
+
+        *pwColorA = wColor[0];
+        *pwColorB = wColor[1];
     }
 
 
@@ -513,8 +1079,13 @@ namespace
             ColorD.a = ColorB.a;
         }
 
-        const uint16_t wColorA = Encode565(&ColorC);
-        const uint16_t wColorB = Encode565(&ColorD);
+        uint16_t wColorA = Encode565(&ColorC);
+        uint16_t wColorB = Encode565(&ColorD);
+
+        if (flags & BC_FLAGS_EFFORT_BEST)
+        {
+            RefineEndPointsBC1(&wColorA, &wColorB, pColor, uSteps, threshold, flags);
+        }
 
         if ((uSteps == 4) && (wColorA == wColorB))
         {
@@ -630,15 +1201,22 @@ namespace
                     Clr.b += Error[i].b;
                 }
 
-                const float fDot = (Clr.r - Step[0].r) * Dir.r + (Clr.g - Step[0].g) * Dir.g + (Clr.b - Step[0].b) * Dir.b;
-
                 uint32_t iStep;
-                if (fDot <= 0.0f)
-                    iStep = 0;
-                else if (fDot >= fSteps)
-                    iStep = 1;
+                if (flags & BC_FLAGS_EFFORT_BEST)
+                {
+                    iStep = FindClosestBC1(&Clr, Step, uSteps, nullptr);
+                }
                 else
-                    iStep = uint32_t(pSteps[uint32_t(fDot + 0.5f)]);
+                {
+                    const float fDot = (Clr.r - Step[0].r) * Dir.r + (Clr.g - Step[0].g) * Dir.g + (Clr.b - Step[0].b) * Dir.b;
+
+                    if (fDot <= 0.0f)
+                        iStep = 0;
+                    else if (fDot >= fSteps)
+                        iStep = 1;
+                    else
+                        iStep = uint32_t(pSteps[uint32_t(fDot + 0.5f)]);
+                }
 
                 dw = (iStep << 30) | (dw >> 2);
 
@@ -684,39 +1262,442 @@ namespace
         pBC->bitmap = dw;
     }
 
+#ifndef COLOR_WEIGHTS
     //-------------------------------------------------------------------------------------
-#ifdef COLOR_WEIGHTS
-    void EncodeSolidBC1(_Out_ D3DX_BC1 *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *pColor)
+    // Encodes NUM_BLOCKS_PER_BATCH BC1 blocks with one block per vector lane. Blocks which
+    // need the three-color (color-keyed) encoding fall back to the scalar encoder.
+    //-------------------------------------------------------------------------------------
+    void EncodeBC1Batch(
+        _Out_writes_(NUM_BLOCKS_PER_BATCH) D3DX_BC1 *pBC,
+        _In_reads_(NUM_PIXELS_PER_BLOCK * NUM_BLOCKS_PER_BATCH) const XMVECTOR *pColor,
+        float threshold,
+        uint32_t flags) noexcept
     {
-    #ifdef COLOR_AVG_0WEIGHTS
-        // Compute avg color
-        HDRColorA Color;
-        Color.r = pColor[0].r;
-        Color.g = pColor[0].g;
-        Color.b = pColor[0].b;
+        assert(pBC && pColor);
+        static_assert(NUM_BLOCKS_PER_BATCH == 4, "Batch size must match the XMVECTOR lane count");
 
-        for (size_t i = 1; i < NUM_PIXELS_PER_BLOCK; ++i)
+        // Transpose into structure-of-arrays form, one block per lane
+        XMVECTOR R[NUM_PIXELS_PER_BLOCK];
+        XMVECTOR G[NUM_PIXELS_PER_BLOCK];
+        XMVECTOR B[NUM_PIXELS_PER_BLOCK];
+        XMVECTOR A[NUM_PIXELS_PER_BLOCK];
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
         {
-            Color.r += pColor[i].r;
-            Color.g += pColor[i].g;
-            Color.b += pColor[i].b;
+            XMMATRIX M(
+                pColor[i],
+                pColor[i + NUM_PIXELS_PER_BLOCK],
+                pColor[i + NUM_PIXELS_PER_BLOCK * 2],
+                pColor[i + NUM_PIXELS_PER_BLOCK * 3]);
+            M = XMMatrixTranspose(M);
+            R[i] = M.r[0];
+            G[i] = M.r[1];
+            B[i] = M.r[2];
+            A[i] = M.r[3];
         }
 
-        Color.r *= 1.0f / 16.0f;
-        Color.g *= 1.0f / 16.0f;
-        Color.b *= 1.0f / 16.0f;
+        // Determine which blocks need to be colorkeyed
+        const XMVECTOR vThreshold = XMVectorReplicate(threshold);
+        XMVECTOR bColorKey = XMVectorFalseInt();
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            bColorKey = XMVectorOrInt(bColorKey, XMVectorLess(A[i], vThreshold));
+        }
 
-        const uint16_t wColor = Encode565(&Color);
-    #else
-        const uint16_t wColor = 0x0000;
-    #endif // COLOR_AVG_0WEIGHTS
+        XMUINT4 colorKey;
+        XMStoreUInt4(&colorKey, bColorKey);
+        const uint32_t uColorKey[NUM_BLOCKS_PER_BATCH] = { colorKey.x, colorKey.y, colorKey.z, colorKey.w };
 
-        // Encode solid block
-        pBC->rgb[0] = wColor;
-        pBC->rgb[1] = wColor;
-        pBC->bitmap = 0x00000000;
+        bool bEncode[NUM_BLOCKS_PER_BATCH];
+        size_t nEncode = 0;
+        for (size_t j = 0; j < NUM_BLOCKS_PER_BATCH; ++j)
+        {
+            bEncode[j] = (uColorKey[j] == 0);
+            if (bEncode[j])
+            {
+                ++nEncode;
+            }
+            else
+            {
+                D3DXEncodeBC1(reinterpret_cast<uint8_t*>(&pBC[j]), pColor + j * NUM_PIXELS_PER_BLOCK, threshold, flags);
+            }
+        }
+
+        if (!nEncode)
+            return;
+
+        // Quantize blocks to R5G6B5
+        const XMVECTOR vLumR = XMVectorReplicate(g_Luminance.r);
+        const XMVECTOR vLumG = XMVectorReplicate(g_Luminance.g);
+        const XMVECTOR vLumB = XMVectorReplicate(g_Luminance.b);
+
+        XMVECTOR QR[NUM_PIXELS_PER_BLOCK];
+        XMVECTOR QG[NUM_PIXELS_PER_BLOCK];
+        XMVECTOR QB[NUM_PIXELS_PER_BLOCK];
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            QR[i] = XMVectorMultiply(XMVectorTruncate(XMVectorAdd(XMVectorScale(R[i], 31.0f), g_XMOneHalf)), XMVectorReplicate(1.0f / 31.0f));
+            QG[i] = XMVectorMultiply(XMVectorTruncate(XMVectorAdd(XMVectorScale(G[i], 63.0f), g_XMOneHalf)), XMVectorReplicate(1.0f / 63.0f));
+            QB[i] = XMVectorMultiply(XMVectorTruncate(XMVectorAdd(XMVectorScale(B[i], 31.0f), g_XMOneHalf)), XMVectorReplicate(1.0f / 31.0f));
+
+            if (!(flags & BC_FLAGS_UNIFORM))
+            {
+                QR[i] = XMVectorMultiply(QR[i], vLumR);
+                QG[i] = XMVectorMultiply(QG[i], vLumG);
+                QB[i] = XMVectorMultiply(QB[i], vLumB);
+            }
+        }
+
+        // Perform 6D root finding function to find two endpoints of color axis.
+        XMVECTOR vX[3], vY[3];
+        OptimizeRGBBatch(vX, vY, QR, QG, QB, flags);
+
+        XM_ALIGNED_DATA(16) float fX[3][NUM_BLOCKS_PER_BATCH];
+        XM_ALIGNED_DATA(16) float fY[3][NUM_BLOCKS_PER_BATCH];
+        for (size_t ch = 0; ch < 3; ++ch)
+        {
+            XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(fX[ch]), vX[ch]);
+            XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(fY[ch]), vY[ch]);
+        }
+
+        // Quantize and sort the endpoints for each block
+        XM_ALIGNED_DATA(16) float fStep0[3][NUM_BLOCKS_PER_BATCH] = {};
+        XM_ALIGNED_DATA(16) float fDir[3][NUM_BLOCKS_PER_BATCH] = {};
+
+        for (size_t j = 0; j < NUM_BLOCKS_PER_BATCH; ++j)
+        {
+            if (!bEncode[j])
+                continue;
+
+            HDRColorA ColorA(fX[0][j], fX[1][j], fX[2][j], 1.0f);
+            HDRColorA ColorB(fY[0][j], fY[1][j], fY[2][j], 1.0f);
+            HDRColorA ColorC, ColorD;
+
+            if (flags & BC_FLAGS_UNIFORM)
+            {
+                ColorC = ColorA;
+                ColorD = ColorB;
+            }
+            else
+            {
+                ColorC.r = ColorA.r * g_LuminanceInv.r;
+                ColorC.g = ColorA.g * g_LuminanceInv.g;
+                ColorC.b = ColorA.b * g_LuminanceInv.b;
+                ColorC.a = ColorA.a;
+
+                ColorD.r = ColorB.r * g_LuminanceInv.r;
+                ColorD.g = ColorB.g * g_LuminanceInv.g;
+                ColorD.b = ColorB.b * g_LuminanceInv.b;
+                ColorD.a = ColorB.a;
+            }
+
+            const uint16_t wColorA = Encode565(&ColorC);
+            const uint16_t wColorB = Encode565(&ColorD);
+
+            if (wColorA == wColorB)
+            {
+                pBC[j].rgb[0] = wColorA;
+                pBC[j].rgb[1] = wColorB;
+                pBC[j].bitmap = 0x00000000;
+                bEncode[j] = false;
+                continue;
+            }
+
+            Decode565(&ColorC, wColorA);
+            Decode565(&ColorD, wColorB);
+
+            if (flags & BC_FLAGS_UNIFORM)
+            {
+                ColorA = ColorC;
+                ColorB = ColorD;
+            }
+            else
+            {
+                ColorA.r = ColorC.r * g_Luminance.r;
+                ColorA.g = ColorC.g * g_Luminance.g;
+                ColorA.b = ColorC.b * g_Luminance.b;
+
+                ColorB.r = ColorD.r * g_Luminance.r;
+                ColorB.g = ColorD.g * g_Luminance.g;
+                ColorB.b = ColorD.b * g_Luminance.b;
+            }
+
+            // Four-color blocks store the larger endpoint first
+            HDRColorA Step0, Step1;
+            if (wColorA > wColorB)
+            {
+                pBC[j].rgb[0] = wColorA;
+                pBC[j].rgb[1] = wColorB;
+
+                Step0 = ColorA;
+                Step1 = ColorB;
+            }
+            else
+            {
+                pBC[j].rgb[0] = wColorB;
+                pBC[j].rgb[1] = wColorA;
+
+                Step0 = ColorB;
+                Step1 = ColorA;
+            }
+
+            // Calculate color direction
+            HDRColorA Dir;
+            Dir.r = Step1.r - Step0.r;
+            Dir.g = Step1.g - Step0.g;
+            Dir.b = Step1.b - Step0.b;
+
+            const float fScale = 3.0f / (Dir.r * Dir.r + Dir.g * Dir.g + Dir.b * Dir.b);
+
+            fStep0[0][j] = Step0.r;
+            fStep0[1][j] = Step0.g;
+            fStep0[2][j] = Step0.b;
+
+            fDir[0][j] = Dir.r * fScale;
+            fDir[1][j] = Dir.g * fScale;
+            fDir[2][j] = Dir.b * fScale;
+        }
+
+        // Encode colors
+        const XMVECTOR Step0r = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(fStep0[0]));
+        const XMVECTOR Step0g = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(fStep0[1]));
+        const XMVECTOR Step0b = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(fStep0[2]));
+
+        const XMVECTOR Dirr = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(fDir[0]));
+        const XMVECTOR Dirg = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(fDir[1]));
+        const XMVECTOR Dirb = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(fDir[2]));
+
+        const XMVECTOR vSteps = XMVectorReplicate(3.0f);
+
+        static const uint32_t pSteps4[] = { 0, 2, 3, 1 };
+
+        uint32_t dw[NUM_BLOCKS_PER_BATCH] = {};
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            XMVECTOR Clrr = R[i];
+            XMVECTOR Clrg = G[i];
+            XMVECTOR Clrb = B[i];
+
+            if (!(flags & BC_FLAGS_UNIFORM))
+            {
+                Clrr = XMVectorMultiply(Clrr, vLumR);
+                Clrg = XMVectorMultiply(Clrg, vLumG);
+                Clrb = XMVectorMultiply(Clrb, vLumB);
+            }
+
+            const XMVECTOR fDot = XMVectorAdd(
+                XMVectorAdd(
+                    XMVectorMultiply(XMVectorSubtract(Clrr, Step0r), Dirr),
+                    XMVectorMultiply(XMVectorSubtract(Clrg, Step0g), Dirg)),
+                XMVectorMultiply(XMVectorSubtract(Clrb, Step0b), Dirb));
+
+            XMVECTOR iStep = XMVectorTruncate(XMVectorAdd(fDot, g_XMOneHalf));
+            iStep = XMVectorSelect(iStep, XMVectorZero(), XMVectorLessOrEqual(fDot, XMVectorZero()));
+            iStep = XMVectorSelect(iStep, vSteps, XMVectorGreaterOrEqual(fDot, vSteps));
+
+            XMFLOAT4A fIndex;
+            XMStoreFloat4A(&fIndex, iStep);
+
+            dw[0] = (pSteps4[static_cast<uint32_t>(fIndex.x) & 3] << 30) | (dw[0] >> 2);
+            dw[1] = (pSteps4[static_cast<uint32_t>(fIndex.y) & 3] << 30) | (dw[1] >> 2);
+            dw[2] = (pSteps4[static_cast<uint32_t>(fIndex.z) & 3] << 30) | (dw[2] >> 2);
+            dw[3] = (pSteps4[static_cast<uint32_t>(fIndex.w) & 3] << 30) | (dw[3] >> 2);
+        }
+
+        for (size_t j = 0; j < NUM_BLOCKS_PER_BATCH; ++j)
+        {
+            if (bEncode[j])
+                pBC[j].bitmap = dw[j];
+        }
+    }
+#endif // !COLOR_WEIGHTS
+
+    //-------------------------------------------------------------------------------------
+#ifdef COLOR_WEIGHTS
+    void EncodeSolidBC1(_Out_ D3DX_BC1 *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *pColor)
+    {
+    #ifdef COLOR_AVG_0WEIGHTS
+        // Compute avg color
+        HDRColorA Color;
+        Color.r = pColor[0].r;
+        Color.g = pColor[0].g;
+        Color.b = pColor[0].b;
+
+        for (size_t i = 1; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            Color.r += pColor[i].r;
+            Color.g += pColor[i].g;
+            Color.b += pColor[i].b;
+        }
+
+        Color.r *= 1.0f / 16.0f;
+        Color.g *= 1.0f / 16.0f;
+        Color.b *= 1.0f / 16.0f;
+
+        const uint16_t wColor = Encode565(&Color);
+    #else
+        const uint16_t wColor = 0x0000;
+    #endif // COLOR_AVG_0WEIGHTS
+
+        // Encode solid block
+        pBC->rgb[0] = wColor;
+        pBC->rgb[1] = wColor;
+        pBC->bitmap = 0x00000000;
     }
 #endif // COLOR_WEIGHTS
+
+
+    //-------------------------------------------------------------------------------------
+    // Builds the BC3 alpha palette the decoder derives from a pair of endpoints
+    //-------------------------------------------------------------------------------------
+    void BuildPaletteBC3(_Out_writes_(8) float *pStep, uint8_t bAlpha0, uint8_t bAlpha1) noexcept
+    {
+        pStep[0] = static_cast<float>(bAlpha0) * (1.0f / 255.0f);
+        pStep[1] = static_cast<float>(bAlpha1) * (1.0f / 255.0f);
+
+        if (bAlpha0 > bAlpha1)
+        {
+            for (size_t i = 1; i < 7; ++i)
+                pStep[i + 1] = (pStep[0] * float(7u - i) + pStep[1] * float(i)) * (1.0f / 7.0f);
+        }
+        else
+        {
+            for (size_t i = 1; i < 5; ++i)
+                pStep[i + 1] = (pStep[0] * float(5u - i) + pStep[1] * float(i)) * (1.0f / 5.0f);
+
+            pStep[6] = 0.0f;
+            pStep[7] = 1.0f;
+        }
+    }
+
+    inline uint32_t FindClosestBC3(float fAlpha, _In_reads_(8) const float *pStep, _Out_opt_ float *pErr) noexcept
+    {
+        uint32_t iBest = 0;
+        float fBestErr = FLT_MAX;
+
+        for (uint32_t iStep = 0; iStep < 8; ++iStep)
+        {
+            const float fDiff = fAlpha - pStep[iStep];
+            const float fErr = fDiff * fDiff;
+            if (fErr < fBestErr)
+            {
+                fBestErr = fErr;
+                iBest = iStep;
+            }
+        }
+
+        if (pErr)
+            *pErr = fBestErr;
+
+        return iBest;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Tries every alpha endpoint pair within a small window of the given endpoints, in
+    // both the 8-value and the 6-value interpolation modes (used for BC_FLAGS_EFFORT_BEST)
+    //-------------------------------------------------------------------------------------
+    void RefineEndPointsBC3(
+        _Inout_ uint8_t *pbAlpha0,
+        _Inout_ uint8_t *pbAlpha1,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *pColor) noexcept
+    {
+        constexpr int iRadius = 4;
+
+        auto fnError = [pColor](uint8_t bAlpha0, uint8_t bAlpha1, float fMaxErr) noexcept -> float
+        {
+            float fStep[8];
+            BuildPaletteBC3(fStep, bAlpha0, bAlpha1);
+
+            float fTotalErr = 0.0f;
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK && fTotalErr < fMaxErr; ++i)
+            {
+                float fErr;
+                FindClosestBC3(pColor[i].a, fStep, &fErr);
+                fTotalErr += fErr;
+            }
+            return fTotalErr;
+        };
+
+        float fBestErr = fnError(*pbAlpha0, *pbAlpha1, FLT_MAX);
+
+        const int iLo = std::min<int>(*pbAlpha0, *pbAlpha1);
+        const int iHi = std::max<int>(*pbAlpha0, *pbAlpha1);
+
+        for (int iA = std::max(iLo - iRadius, 0); iA <= std::min(iLo + iRadius, 255) && (fBestErr > 0.0f); ++iA)
+        {
+            for (int iB = std::max(iHi - iRadius, iA); iB <= std::min(iHi + iRadius, 255); ++iB)
+            {
+                // alpha0 > alpha1 selects the 8-value mode, otherwise the 6-value mode
+                const auto bA = static_cast<uint8_t>(iA);
+                const auto bB = static_cast<uint8_t>(iB);
+
+                float fErr = fnError(bB, bA, fBestErr);
+                if (fErr < fBestErr)
+                {
+                    fBestErr = fErr;
+                    *pbAlpha0 = bB;
+                    *pbAlpha1 = bA;
+                }
+
+                if (iA != iB)
+                {
+                    fErr = fnError(bA, bB, fBestErr);
+                    if (fErr < fBestErr)
+                    {
+                        fBestErr = fErr;
+                        *pbAlpha0 = bA;
+                        *pbAlpha1 = bB;
+                    }
+                }
+            }
+        }
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Encodes a block where every pixel has the same color using the single color tables
+    //-------------------------------------------------------------------------------------
+    inline size_t ToUNorm8(float f) noexcept
+    {
+        f = (f < 0.0f) ? 0.0f : (f > 1.0f) ? 1.0f : f;
+        return static_cast<size_t>(f * 255.0f + 0.5f);
+    }
+
+    void EncodeSingleColorBC1(
+        _Out_ D3DX_BC1 *pBC,
+        _In_ const HDRColorA *pColor,
+        bool isbc1) noexcept
+    {
+        const size_t r = ToUNorm8(pColor->r);
+        const size_t g = ToUNorm8(pColor->g);
+        const size_t b = ToUNorm8(pColor->b);
+
+        const auto wColor0 = static_cast<uint16_t>((g_aMatch5[r][0] << 11) | (g_aMatch6[g][0] << 5) | g_aMatch5[b][0]);
+        const auto wColor1 = static_cast<uint16_t>((g_aMatch5[r][1] << 11) | (g_aMatch6[g][1] << 5) | g_aMatch5[b][1]);
+
+        if (wColor0 == wColor1)
+        {
+            pBC->rgb[0] = wColor0;
+            pBC->rgb[1] = wColor1;
+            pBC->bitmap = 0x00000000;
+        }
+        else if (!isbc1 || (wColor0 > wColor1))
+        {
+            // Every pixel uses the 1/3 interpolant (index 2)
+            pBC->rgb[0] = wColor0;
+            pBC->rgb[1] = wColor1;
+            pBC->bitmap = 0xaaaaaaaa;
+        }
+        else
+        {
+            // BC1 needs color0 > color1 for four-color mode, so swap and use the 2/3 interpolant (index 3)
+            pBC->rgb[0] = wColor1;
+            pBC->rgb[1] = wColor0;
+            pBC->bitmap = 0xffffffff;
+        }
+    }
 }
 
 
@@ -734,6 +1715,18 @@ void DirectX::D3DXDecodeBC1(XMVECTOR *pColor, const uint8_t *pBC) noexcept
     DecodeBC1(pColor, pBC1, true);
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC1ToRGBA8(XMUBYTEN4 *pColor, const uint8_t *pBC, size_t count) noexcept
+{
+    assert(pColor && pBC);
+
+    for (size_t j = 0; j < count; ++j)
+    {
+        auto pBC1 = reinterpret_cast<const D3DX_BC1 *>(pBC + j * sizeof(D3DX_BC1));
+        DecodeBC1(&pColor[j * NUM_PIXELS_PER_BLOCK], pBC1, true);
+    }
+}
+
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC1(uint8_t *pBC, const XMVECTOR *pColor, float threshold, uint32_t flags) noexcept
 {
@@ -794,6 +1787,58 @@ void DirectX::D3DXEncodeBC1(uint8_t *pBC, const XMVECTOR *pColor, float threshol
     EncodeBC1(pBC1, Color, true, threshold, flags);
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC1Batch(uint8_t *pBC, const XMVECTOR *pColor, float threshold, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
+    static_assert(sizeof(D3DX_BC1) == 8, "D3DX_BC1 should be 8 bytes");
+
+#ifndef COLOR_WEIGHTS
+    if (!(flags & (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A | BC_FLAGS_EFFORT_BEST)))
+    {
+        auto pBC1 = reinterpret_cast<D3DX_BC1 *>(pBC);
+        EncodeBC1Batch(pBC1, pColor, threshold, flags);
+        return;
+    }
+#endif // !COLOR_WEIGHTS
+
+    // Error diffusion and the endpoint search are sequential within each block, so use the single block encoder
+    for (size_t j = 0; j < NUM_BLOCKS_PER_BATCH; ++j)
+    {
+        D3DXEncodeBC1(pBC + j * sizeof(D3DX_BC1), pColor + j * NUM_PIXELS_PER_BLOCK, threshold, flags);
+    }
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeSolidBC1(uint8_t *pBC, const XMVECTOR *pColor, float threshold, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
+    static_assert(sizeof(D3DX_BC1) == 8, "D3DX_BC1 should be 8 bytes");
+
+    if (flags & (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A))
+    {
+        D3DXEncodeBC1(pBC, pColor, threshold, flags);
+        return;
+    }
+
+    XMFLOAT4A clr;
+    XMStoreFloat4A(&clr, pColor[0]);
+
+    const HDRColorA Color(clr.x, clr.y, clr.z, clr.w);
+
+    auto pBC1 = reinterpret_cast<D3DX_BC1 *>(pBC);
+
+    if (Color.a < threshold)
+    {
+        pBC1->rgb[0] = 0x0000;
+        pBC1->rgb[1] = 0xffff;
+        pBC1->bitmap = 0xffffffff;
+        return;
+    }
+
+    EncodeSingleColorBC1(pBC1, &Color, true);
+}
+
 
 //-------------------------------------------------------------------------------------
 // BC2 Compression
@@ -824,6 +1869,30 @@ void DirectX::D3DXDecodeBC2(XMVECTOR *pColor, const uint8_t *pBC) noexcept
         pColor[i] = XMVectorSetW(pColor[i], static_cast<float>(dw & 0xf) * (1.0f / 15.0f));
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC2ToRGBA8(XMUBYTEN4 *pColor, const uint8_t *pBC, size_t count) noexcept
+{
+    assert(pColor && pBC);
+    static_assert(sizeof(D3DX_BC2) == 16, "D3DX_BC2 should be 16 bytes");
+
+    for (size_t j = 0; j < count; ++j)
+    {
+        auto pBC2 = reinterpret_cast<const D3DX_BC2 *>(pBC + j * sizeof(D3DX_BC2));
+        XMUBYTEN4* pBlock = &pColor[j * NUM_PIXELS_PER_BLOCK];
+
+        // RGB part
+        DecodeBC1(pBlock, &pBC2->bc1, false);
+
+        // 4-bit alpha part, where a value of n is n * 17 in 8 bits
+        const uint64_t dw = uint64_t(pBC2->bitmap[0]) | (uint64_t(pBC2->bitmap[1]) << 32);
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            pBlock[i].w = static_cast<uint8_t>(((dw >> (4 * i)) & 0xf) * 17u);
+        }
+    }
+}
+
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC2(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
@@ -894,6 +1963,34 @@ void DirectX::D3DXEncodeBC2(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags
     EncodeBC1(&pBC2->bc1, Color, false, 0.f, flags);
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXEncodeSolidBC2(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
+    static_assert(sizeof(D3DX_BC2) == 16, "D3DX_BC2 should be 16 bytes");
+
+    if (flags & (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A))
+    {
+        D3DXEncodeBC2(pBC, pColor, flags);
+        return;
+    }
+
+    XMFLOAT4A clr;
+    XMStoreFloat4A(&clr, pColor[0]);
+
+    const HDRColorA Color(clr.x, clr.y, clr.z, clr.w);
+
+    auto pBC2 = reinterpret_cast<D3DX_BC2 *>(pBC);
+
+    // 4-bit alpha part
+    const auto u = static_cast<uint32_t>(Color.a * 15.0f + 0.5f);
+
+    pBC2->bitmap[0] = pBC2->bitmap[1] = u * 0x11111111;
+
+    // RGB part
+    EncodeSingleColorBC1(&pBC2->bc1, &Color, false);
+}
+
 
 //-------------------------------------------------------------------------------------
 // BC3 Compression
@@ -911,23 +2008,7 @@ void DirectX::D3DXDecodeBC3(XMVECTOR *pColor, const uint8_t *pBC) noexcept
 
     // Adaptive 3-bit alpha part
     float fAlpha[8];
-
-    fAlpha[0] = static_cast<float>(pBC3->alpha[0]) * (1.0f / 255.0f);
-    fAlpha[1] = static_cast<float>(pBC3->alpha[1]) * (1.0f / 255.0f);
-
-    if (pBC3->alpha[0] > pBC3->alpha[1])
-    {
-        for (size_t i = 1; i < 7; ++i)
-            fAlpha[i + 1] = (fAlpha[0] * float(7u - i) + fAlpha[1] * float(i)) * (1.0f / 7.0f);
-    }
-    else
-    {
-        for (size_t i = 1; i < 5; ++i)
-            fAlpha[i + 1] = (fAlpha[0] * float(5u - i) + fAlpha[1] * float(i)) * (1.0f / 5.0f);
-
-        fAlpha[6] = 0.0f;
-        fAlpha[7] = 1.0f;
-    }
+    DecodeBC3AlphaPalette(fAlpha, pBC3);
 
     uint32_t dw = uint32_t(pBC3->bitmap[0]) | uint32_t(pBC3->bitmap[1] << 8) | uint32_t(pBC3->bitmap[2] << 16);
 
@@ -940,6 +2021,40 @@ void DirectX::D3DXDecodeBC3(XMVECTOR *pColor, const uint8_t *pBC) noexcept
         pColor[i] = XMVectorSetW(pColor[i], fAlpha[dw & 0x7]);
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC3ToRGBA8(XMUBYTEN4 *pColor, const uint8_t *pBC, size_t count) noexcept
+{
+    assert(pColor && pBC);
+    static_assert(sizeof(D3DX_BC3) == 16, "D3DX_BC3 should be 16 bytes");
+
+    for (size_t j = 0; j < count; ++j)
+    {
+        auto pBC3 = reinterpret_cast<const D3DX_BC3 *>(pBC + j * sizeof(D3DX_BC3));
+        XMUBYTEN4* pBlock = &pColor[j * NUM_PIXELS_PER_BLOCK];
+
+        // RGB part
+        DecodeBC1(pBlock, &pBC3->bc1, false);
+
+        // Adaptive 3-bit alpha part, converted to 8 bits four values at a time
+        XM_ALIGNED_DATA(16) float fAlpha[8];
+        DecodeBC3AlphaPalette(fAlpha, pBC3);
+
+        XMUBYTEN4 aAlpha[2];
+        XMStoreUByteN4(&aAlpha[0], XMVectorAdd(XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&fAlpha[0])), g_8BitBias));
+        XMStoreUByteN4(&aAlpha[1], XMVectorAdd(XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&fAlpha[4])), g_8BitBias));
+        auto pAlpha = reinterpret_cast<const uint8_t*>(aAlpha);
+
+        uint64_t dw = 0;
+        for (size_t k = 0; k < 6; ++k)
+            dw |= uint64_t(pBC3->bitmap[k]) << (8 * k);
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i, dw >>= 3)
+        {
+            pBlock[i].w = pAlpha[dw & 0x7];
+        }
+    }
+}
+
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC3(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
@@ -1027,13 +2142,35 @@ void DirectX::D3DXEncodeBC3(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags
     }
 
     // Optimize and Quantize Min and Max values
-    const uint32_t uSteps = ((0.0f == fMinAlpha) || (1.0f == fMaxAlpha)) ? 6u : 8u;
+    uint32_t uSteps = ((0.0f == fMinAlpha) || (1.0f == fMaxAlpha)) ? 6u : 8u;
 
     float fAlphaA, fAlphaB;
-    OptimizeAlpha<false>(&fAlphaA, &fAlphaB, fAlpha, uSteps);
+    OptimizeAlpha<false>(&fAlphaA, &fAlphaB, fAlpha, uSteps, flags);
+
+    auto bAlphaA = static_cast<uint8_t>(static_cast<int32_t>(fAlphaA * 255.0f + 0.5f));
+    auto bAlphaB = static_cast<uint8_t>(static_cast<int32_t>(fAlphaB * 255.0f + 0.5f));
+
+    if (flags & BC_FLAGS_EFFORT_BEST)
+    {
+        uint8_t bAlpha0 = (6 == uSteps) ? bAlphaA : bAlphaB;
+        uint8_t bAlpha1 = (6 == uSteps) ? bAlphaB : bAlphaA;
 
-    const auto bAlphaA = static_cast<uint8_t>(static_cast<int32_t>(fAlphaA * 255.0f + 0.5f));
-    const auto bAlphaB = static_cast<uint8_t>(static_cast<int32_t>(fAlphaB * 255.0f + 0.5f));
+        RefineEndPointsBC3(&bAlpha0, &bAlpha1, Color);
+
+        // The endpoint order selects the interpolation mode
+        if (bAlpha0 > bAlpha1)
+        {
+            uSteps = 8;
+            bAlphaA = bAlpha1;
+            bAlphaB = bAlpha0;
+        }
+        else
+        {
+            uSteps = 6;
+            bAlphaA = bAlpha0;
+            bAlphaB = bAlpha1;
+        }
+    }
 
     fAlphaA = static_cast<float>(bAlphaA) * (1.0f / 255.0f);
     fAlphaB = static_cast<float>(bAlphaB) * (1.0f / 255.0f);
@@ -1102,15 +2239,22 @@ void DirectX::D3DXEncodeBC3(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags
             float fAlph = Color[i].a;
             if (flags & BC_FLAGS_DITHER_A)
                 fAlph += fError[i];
-            const float fDot = (fAlph - fStep[0]) * fScale;
-
             uint32_t iStep;
-            if (fDot <= 0.0f)
-                iStep = ((6 == uSteps) && (fAlph <= fStep[0] * 0.5f)) ? 6u : 0u;
-            else if (fDot >= fSteps)
-                iStep = ((6 == uSteps) && (fAlph >= (fStep[1] + 1.0f) * 0.5f)) ? 7u : 1u;
+            if (flags & BC_FLAGS_EFFORT_BEST)
+            {
+                iStep = FindClosestBC3(fAlph, fStep, nullptr);
+            }
             else
-                iStep = uint32_t(pSteps[uint32_t(fDot + 0.5f)]);
+            {
+                const float fDot = (fAlph - fStep[0]) * fScale;
+
+                if (fDot <= 0.0f)
+                    iStep = ((6 == uSteps) && (fAlph <= fStep[0] * 0.5f)) ? 6u : 0u;
+                else if (fDot >= fSteps)
+                    iStep = ((6 == uSteps) && (fAlph >= (fStep[1] + 1.0f) * 0.5f)) ? 7u : 1u;
+                else
+                    iStep = uint32_t(pSteps[uint32_t(fDot + 0.5f)]);
+            }
 
             dw = (iStep << 21) | (dw >> 3);
 
@@ -1139,3 +2283,30 @@ void DirectX::D3DXEncodeBC3(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags
         pBC3->bitmap[2 + iSet * 3] = reinterpret_cast<uint8_t *>(&dw)[2];
     }
 }
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeSolidBC3(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
+    static_assert(sizeof(D3DX_BC3) == 16, "D3DX_BC3 should be 16 bytes");
+
+    if (flags & (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A))
+    {
+        D3DXEncodeBC3(pBC, pColor, flags);
+        return;
+    }
+
+    XMFLOAT4A clr;
+    XMStoreFloat4A(&clr, pColor[0]);
+
+    const HDRColorA Color(clr.x, clr.y, clr.z, clr.w);
+
+    auto pBC3 = reinterpret_cast<D3DX_BC3 *>(pBC);
+
+    // Any 8-bit alpha is exact as the first endpoint
+    pBC3->alpha[0] = pBC3->alpha[1] = static_cast<uint8_t>(ToUNorm8(Color.a));
+    memset(pBC3->bitmap, 0x00, 6);
+
+    // RGB part
+    EncodeSingleColorBC1(&pBC3->bc1, &Color, false);
+}
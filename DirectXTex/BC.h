@@ -22,6 +22,7 @@ namespace DirectX
 
 // Because these are used in SAL annotations, they need to remain macros rather than const values
 #define NUM_PIXELS_PER_BLOCK 16
+#define NUM_BLOCKS_PER_BATCH 4
 
 //-------------------------------------------------------------------------------------
 // Constants
@@ -45,6 +46,18 @@ namespace DirectX
 
         BC_FLAGS_FORCE_BC7_MODE6 = 0x100000,
         // BC7 should only use mode 6; skip other modes
+
+        BC_FLAGS_EFFORT_FAST = 0x200000,
+        // BC1-5 use range-fit endpoints; skip the iterative endpoint refinement. BC7 skips modes and rotations the block analysis deems unlikely to win
+
+        BC_FLAGS_EFFORT_BEST = 0x400000,
+        // BC1-5 search the neighborhood of the refined endpoints for the lowest error encoding
+
+        BC_FLAGS_BC6H_QUICK = 0x800000,
+        // BC6H tries three one region modes, then three two region modes with the best shape when that shape beats them
+
+        BC_FLAGS_BC7_BATCH = 0x8000000,
+        // BC7 is encoded NUM_BLOCKS_PER_BATCH blocks at a time by D3DXEncodeBC7Batch
     };
 
     //-------------------------------------------------------------------------------------
@@ -184,7 +197,7 @@ namespace DirectX
 //-------------------------------------------------------------------------------------
 #pragma warning(push)
 #pragma warning(disable : 4127)
-    template <bool bRange> void OptimizeAlpha(float *pX, float *pY, const float *pPoints, uint32_t cSteps) noexcept
+    template <bool bRange> void OptimizeAlpha(float *pX, float *pY, const float *pPoints, uint32_t cSteps, uint32_t flags) noexcept
     {
         static const float pC6[] = { 5.0f / 5.0f, 4.0f / 5.0f, 3.0f / 5.0f, 2.0f / 5.0f, 1.0f / 5.0f, 0.0f / 5.0f };
         static const float pD6[] = { 0.0f / 5.0f, 1.0f / 5.0f, 2.0f / 5.0f, 3.0f / 5.0f, 4.0f / 5.0f, 5.0f / 5.0f };
@@ -231,8 +244,9 @@ namespace DirectX
 
         // Use Newton's Method to find local minima of sum-of-squares error.
         const auto fSteps = static_cast<float>(cSteps - 1);
+        const size_t cIterations = (flags & BC_FLAGS_EFFORT_FAST) ? 0 : 8;
 
-        for (size_t iIteration = 0; iIteration < 8; iIteration++)
+        for (size_t iIteration = 0; iIteration < cIterations; iIteration++)
         {
             if ((fY - fX) < (1.0f / 256.0f))
                 break;
@@ -329,9 +343,23 @@ namespace DirectX
     void D3DXDecodeBC6HS(_Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR *pColor, _In_reads_(16) const uint8_t *pBC) noexcept;
     void D3DXDecodeBC7(_Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR *pColor, _In_reads_(16) const uint8_t *pBC) noexcept;
 
+    void D3DXDecodeBC1ToRGBA8(_Out_writes_(NUM_PIXELS_PER_BLOCK * count) PackedVector::XMUBYTEN4 *pColor, _In_reads_(8 * count) const uint8_t *pBC, _In_ size_t count) noexcept;
+    void D3DXDecodeBC2ToRGBA8(_Out_writes_(NUM_PIXELS_PER_BLOCK * count) PackedVector::XMUBYTEN4 *pColor, _In_reads_(16 * count) const uint8_t *pBC, _In_ size_t count) noexcept;
+    void D3DXDecodeBC3ToRGBA8(_Out_writes_(NUM_PIXELS_PER_BLOCK * count) PackedVector::XMUBYTEN4 *pColor, _In_reads_(16 * count) const uint8_t *pBC, _In_ size_t count) noexcept;
+    void D3DXDecodeBC4UToR8(_Out_writes_(NUM_PIXELS_PER_BLOCK * count) uint8_t *pRed, _In_reads_(8 * count) const uint8_t *pBC, _In_ size_t count) noexcept;
+    void D3DXDecodeBC5UToR8G8(_Out_writes_(NUM_PIXELS_PER_BLOCK * count) PackedVector::XMUBYTEN2 *pColor, _In_reads_(16 * count) const uint8_t *pBC, _In_ size_t count) noexcept;
+    void D3DXDecodeBC6HUToHalf(_Out_writes_(NUM_PIXELS_PER_BLOCK * count) PackedVector::XMHALF4 *pColor, _In_reads_(16 * count) const uint8_t *pBC, _In_ size_t count) noexcept;
+    void D3DXDecodeBC6HSToHalf(_Out_writes_(NUM_PIXELS_PER_BLOCK * count) PackedVector::XMHALF4 *pColor, _In_reads_(16 * count) const uint8_t *pBC, _In_ size_t count) noexcept;
+    void D3DXDecodeBC7ToRGBA8(_Out_writes_(NUM_PIXELS_PER_BLOCK * count) PackedVector::XMUBYTEN4 *pColor, _In_reads_(16 * count) const uint8_t *pBC, _In_ size_t count) noexcept;
+        // Decode count consecutive blocks straight to the pixel format Decompress writes by default, block after block.
+        // The pixels match decoding to XMVECTOR and writing the result with StoreScanline.
+
     void D3DXEncodeBC1(_Out_writes_(8) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ float threshold, _In_ uint32_t flags) noexcept;
         // BC1 requires one additional parameter, so it doesn't match signature of BC_ENCODE above
 
+    void D3DXEncodeBC1Batch(_Out_writes_(8 * NUM_BLOCKS_PER_BATCH) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK * NUM_BLOCKS_PER_BATCH) const XMVECTOR *pColor, _In_ float threshold, _In_ uint32_t flags) noexcept;
+        // Encodes NUM_BLOCKS_PER_BATCH consecutive BC1 blocks at once, one block per SIMD lane
+
     void D3DXEncodeBC2(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
     void D3DXEncodeBC3(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
     void D3DXEncodeBC4U(_Out_writes_(8) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
@@ -342,4 +370,40 @@ namespace DirectX
     void D3DXEncodeBC6HS(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
     void D3DXEncodeBC7(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
 
+    void D3DXEncodeBC6HU(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ float errorTarget, _In_ uint32_t flags) noexcept;
+    void D3DXEncodeBC6HS(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ float errorTarget, _In_ uint32_t flags) noexcept;
+    void D3DXEncodeBC7(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ float errorTarget, _In_ uint32_t flags) noexcept;
+        // Stop searching once the mean squared error per pixel is at or below errorTarget (see CompressOptions)
+
+    void D3DXEncodeBC6HUFromHalf(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const PackedVector::XMHALF4 *pColor, _In_ float errorTarget, _In_ uint32_t flags) noexcept;
+    void D3DXEncodeBC6HSFromHalf(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const PackedVector::XMHALF4 *pColor, _In_ float errorTarget, _In_ uint32_t flags) noexcept;
+        // Encodes DXGI_FORMAT_R16G16B16A16_FLOAT pixels without the round trip through XMVECTOR
+
+    void D3DXEncodeBC7FromRGBA8(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const PackedVector::XMUBYTEN4 *pColor, _In_ float errorTarget, _In_ uint32_t flags) noexcept;
+        // Encodes 8-bit RGBA pixels as they are, without quantizing floats back to 8-bit
+
+    void D3DXEncodeBC7Batch(_Out_writes_(16 * NUM_BLOCKS_PER_BATCH) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK * NUM_BLOCKS_PER_BATCH) const XMVECTOR *pColor, _In_ float errorTarget, _In_ uint32_t flags) noexcept;
+        // Encodes NUM_BLOCKS_PER_BATCH consecutive BC7 blocks at once, searching modes 1, 3, 5 and 6 with one block per SIMD lane
+
+    void D3DXEncodeSolidBC1(_Out_writes_(8) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ float threshold, _In_ uint32_t flags) noexcept;
+    void D3DXEncodeSolidBC2(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
+    void D3DXEncodeSolidBC3(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
+    void D3DXEncodeSolidBC4U(_Out_writes_(8) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
+    void D3DXEncodeSolidBC4S(_Out_writes_(8) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
+    void D3DXEncodeSolidBC5U(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
+    void D3DXEncodeSolidBC5S(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
+        // Table-driven encoders for blocks where every pixel has the same value (see IsSolidBlock)
+
+    inline bool IsSolidBlock(_In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ FXMVECTOR channelMask) noexcept
+    {
+        // Compares the channels selected by channelMask of every pixel against the first one
+        XMVECTOR diff = XMVectorZero();
+        for (size_t i = 1; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            diff = XMVectorOrInt(diff, XMVectorXorInt(pColor[i], pColor[0]));
+        }
+
+        return XMVector4EqualInt(XMVectorAndInt(diff, channelMask), XMVectorZero());
+    }
+
 } // namespace
@@ -178,12 +178,115 @@ namespace
         *piSNorm = static_cast<int8_t>(fVal);
     }
 
+    //-------------------------------------------------------------------------------------
+    // Convert a floating point value to an 8-bit UNORM
+    //-------------------------------------------------------------------------------------
+    inline uint8_t FloatToUNorm(_In_ float fVal) noexcept
+    {
+        if (isnan(fVal))
+            fVal = 0;
+        else
+            if (fVal > 1)
+                fVal = 1;    // Clamp to 1
+            else
+                if (fVal < 0)
+                    fVal = 0;    // Clamp to 0
+
+        return static_cast<uint8_t>(fVal * 255.0f + 0.5f);
+    }
+
+
+    //------------------------------------------------------------------------------
+    // Sum of squared errors of the block when every texel picks its closest decoded value
+    template <class BC4_T>
+    float ComputeErrorBC4(
+        _In_ const BC4_T& block,
+        _In_reads_(BLOCK_SIZE) const float theTexelsU[],
+        float fMaxErr) noexcept
+    {
+        float rGradient[8];
+        for (size_t i = 0; i < 8; ++i)
+        {
+            rGradient[i] = block.DecodeFromIndex(i);
+        }
+
+        float fTotalErr = 0.f;
+        for (size_t i = 0; i < BLOCK_SIZE && fTotalErr < fMaxErr; ++i)
+        {
+            float fBestErr = FLT_MAX;
+            for (size_t uIndex = 0; uIndex < 8; uIndex++)
+            {
+                const float fDiff = rGradient[uIndex] - theTexelsU[i];
+                fBestErr = std::min(fBestErr, fDiff * fDiff);
+            }
+            fTotalErr += fBestErr;
+        }
+
+        return fTotalErr;
+    }
+
+    // Tries every endpoint pair within a small window of the given endpoints, in both the
+    // 8-value and the 6-value interpolation modes (used for BC_FLAGS_EFFORT_BEST)
+    template <class BC4_T, class T>
+    void RefineEndPointsBC4(
+        _In_reads_(BLOCK_SIZE) const float theTexelsU[],
+        _Inout_ T &endpointU_0,
+        _Inout_ T &endpointU_1,
+        int iMinCode,
+        int iMaxCode) noexcept
+    {
+        constexpr int iRadius = 4;
+
+        BC4_T block;
+        block.data = 0;
+        block.red_0 = endpointU_0;
+        block.red_1 = endpointU_1;
+
+        float fBestErr = ComputeErrorBC4(block, theTexelsU, FLT_MAX);
+
+        const int iLo = std::min<int>(endpointU_0, endpointU_1);
+        const int iHi = std::max<int>(endpointU_0, endpointU_1);
+
+        for (int iA = std::max(iLo - iRadius, iMinCode); iA <= std::min(iLo + iRadius, iMaxCode) && (fBestErr > 0.f); ++iA)
+        {
+            for (int iB = std::max(iHi - iRadius, iA); iB <= std::min(iHi + iRadius, iMaxCode); ++iB)
+            {
+                // red_0 > red_1 selects the 8-value mode, otherwise the 6-value mode
+                block.red_0 = static_cast<T>(iB);
+                block.red_1 = static_cast<T>(iA);
+
+                float fErr = ComputeErrorBC4(block, theTexelsU, fBestErr);
+                if (fErr < fBestErr)
+                {
+                    fBestErr = fErr;
+                    endpointU_0 = block.red_0;
+                    endpointU_1 = block.red_1;
+                }
+
+                if (iA != iB)
+                {
+                    block.red_0 = static_cast<T>(iA);
+                    block.red_1 = static_cast<T>(iB);
+
+                    fErr = ComputeErrorBC4(block, theTexelsU, fBestErr);
+                    if (fErr < fBestErr)
+                    {
+                        fBestErr = fErr;
+                        endpointU_0 = block.red_0;
+                        endpointU_1 = block.red_1;
+                    }
+                }
+            }
+        }
+    }
+
 
     //------------------------------------------------------------------------------
     void FindEndPointsBC4U(
         _In_reads_(BLOCK_SIZE) const float theTexelsU[],
         _Out_ uint8_t &endpointU_0,
-        _Out_ uint8_t &endpointU_1) noexcept
+        _Out_ uint8_t &endpointU_1,
+        _In_ uint32_t flags) noexcept
     {
         // The boundary of codec for signed/unsigned format
         constexpr float MIN_NORM = 0.f;
@@ -214,7 +317,7 @@ namespace
         if (!bUsing4BlockCodec)
         {
             // 6 interpolated color values
-            OptimizeAlpha<false>(&fStart, &fEnd, theTexelsU, 8);
+            OptimizeAlpha<false>(&fStart, &fEnd, theTexelsU, 8, flags);
 
             auto iStart = static_cast<uint8_t>(fStart * 255.0f);
             auto iEnd = static_cast<uint8_t>(fEnd * 255.0f);
@@ -225,7 +328,7 @@ namespace
         else
         {
             // 4 interpolated color values
-            OptimizeAlpha<false>(&fStart, &fEnd, theTexelsU, 6);
+            OptimizeAlpha<false>(&fStart, &fEnd, theTexelsU, 6, flags);
 
             auto iStart = static_cast<uint8_t>(fStart * 255.0f);
             auto iEnd = static_cast<uint8_t>(fEnd * 255.0f);
@@ -233,12 +336,18 @@ namespace
             endpointU_1 = iEnd;
             endpointU_0 = iStart;
         }
+
+        if (flags & BC_FLAGS_EFFORT_BEST)
+        {
+            RefineEndPointsBC4<BC4_UNORM>(theTexelsU, endpointU_0, endpointU_1, 0, 255);
+        }
     }
 
     void FindEndPointsBC4S(
         _In_reads_(BLOCK_SIZE) const float theTexelsU[],
         _Out_ int8_t &endpointU_0,
-        _Out_ int8_t &endpointU_1) noexcept
+        _Out_ int8_t &endpointU_1,
+        _In_ uint32_t flags) noexcept
     {
         //  The boundary of codec for signed/unsigned format
         constexpr float MIN_NORM = -1.f;
@@ -269,7 +378,7 @@ namespace
         if (!bUsing4BlockCodec)
         {
             // 6 interpolated color values
-            OptimizeAlpha<true>(&fStart, &fEnd, theTexelsU, 8);
+            OptimizeAlpha<true>(&fStart, &fEnd, theTexelsU, 8, flags);
 
             int8_t iStart, iEnd;
             FloatToSNorm(fStart, &iStart);
@@ -281,7 +390,7 @@ namespace
         else
         {
             // 4 interpolated color values
-            OptimizeAlpha<true>(&fStart, &fEnd, theTexelsU, 6);
+            OptimizeAlpha<true>(&fStart, &fEnd, theTexelsU, 6, flags);
 
             int8_t iStart, iEnd;
             FloatToSNorm(fStart, &iStart);
@@ -290,6 +399,11 @@ namespace
             endpointU_1 = iEnd;
             endpointU_0 = iStart;
         }
+
+        if (flags & BC_FLAGS_EFFORT_BEST)
+        {
+            RefineEndPointsBC4<BC4_SNORM>(theTexelsU, endpointU_0, endpointU_1, -127, 127);
+        }
     }
 
 
@@ -300,11 +414,12 @@ namespace
         _Out_ uint8_t &endpointU_0,
         _Out_ uint8_t &endpointU_1,
         _Out_ uint8_t &endpointV_0,
-        _Out_ uint8_t &endpointV_1) noexcept
+        _Out_ uint8_t &endpointV_1,
+        _In_ uint32_t flags) noexcept
     {
         //Encoding the U and V channel by BC4 codec separately.
-        FindEndPointsBC4U(theTexelsU, endpointU_0, endpointU_1);
-        FindEndPointsBC4U(theTexelsV, endpointV_0, endpointV_1);
+        FindEndPointsBC4U(theTexelsU, endpointU_0, endpointU_1, flags);
+        FindEndPointsBC4U(theTexelsV, endpointV_0, endpointV_1, flags);
     }
 
     inline void FindEndPointsBC5S(
@@ -313,11 +428,12 @@ namespace
         _Out_ int8_t &endpointU_0,
         _Out_ int8_t &endpointU_1,
         _Out_ int8_t &endpointV_0,
-        _Out_ int8_t &endpointV_1) noexcept
+        _Out_ int8_t &endpointV_1,
+        _In_ uint32_t flags) noexcept
     {
         //Encoding the U and V channel by BC4 codec separately.
-        FindEndPointsBC4S(theTexelsU, endpointU_0, endpointU_1);
-        FindEndPointsBC4S(theTexelsV, endpointV_0, endpointV_1);
+        FindEndPointsBC4S(theTexelsU, endpointU_0, endpointU_1, flags);
+        FindEndPointsBC4S(theTexelsV, endpointV_0, endpointV_1, flags);
     }
 
 
@@ -400,6 +516,31 @@ void DirectX::D3DXDecodeBC4U(XMVECTOR *pColor, const uint8_t *pBC) noexcept
     }
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC4UToR8(uint8_t *pRed, const uint8_t *pBC, size_t count) noexcept
+{
+    assert(pRed && pBC);
+    static_assert(sizeof(BC4_UNORM) == 8, "BC4_UNORM should be 8 bytes");
+
+    for (size_t j = 0; j < count; ++j)
+    {
+        auto pBC4 = reinterpret_cast<const BC4_UNORM*>(pBC + j * sizeof(BC4_UNORM));
+
+        // Converted the same way StoreScanline writes DXGI_FORMAT_R8_UNORM
+        uint8_t aPalette[8];
+        for (size_t k = 0; k < 8; ++k)
+        {
+            const float v = std::max<float>(std::min<float>(pBC4->DecodeFromIndex(k), 1.f), 0.f);
+            aPalette[k] = static_cast<uint8_t>(v * 255.f);
+        }
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            pRed[j * NUM_PIXELS_PER_BLOCK + i] = aPalette[pBC4->GetIndex(i)];
+        }
+    }
+}
+
 _Use_decl_annotations_
 void DirectX::D3DXDecodeBC4S(XMVECTOR *pColor, const uint8_t *pBC) noexcept
 {
@@ -418,8 +559,6 @@ void DirectX::D3DXDecodeBC4S(XMVECTOR *pColor, const uint8_t *pBC) noexcept
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC4U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
-
     assert(pBC && pColor);
     static_assert(sizeof(BC4_UNORM) == 8, "BC4_UNORM should be 8 bytes");
 
@@ -432,15 +571,13 @@ void DirectX::D3DXEncodeBC4U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
         theTexelsU[i] = XMVectorGetX(pColor[i]);
     }
 
-    FindEndPointsBC4U(theTexelsU, pBC4->red_0, pBC4->red_1);
+    FindEndPointsBC4U(theTexelsU, pBC4->red_0, pBC4->red_1, flags);
     FindClosestUNORM(pBC4, theTexelsU);
 }
 
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC4S(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
-
     assert(pBC && pColor);
     static_assert(sizeof(BC4_SNORM) == 8, "BC4_SNORM should be 8 bytes");
 
@@ -453,10 +590,40 @@ void DirectX::D3DXEncodeBC4S(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
         theTexelsU[i] = XMVectorGetX(pColor[i]);
     }
 
-    FindEndPointsBC4S(theTexelsU, pBC4->red_0, pBC4->red_1);
+    FindEndPointsBC4S(theTexelsU, pBC4->red_0, pBC4->red_1, flags);
     FindClosestSNORM(pBC4, theTexelsU);
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXEncodeSolidBC4U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
+{
+    UNREFERENCED_PARAMETER(flags);
+
+    assert(pBC && pColor);
+    static_assert(sizeof(BC4_UNORM) == 8, "BC4_UNORM should be 8 bytes");
+
+    // Any 8-bit value is exact as the first endpoint, so every texel uses index 0
+    memset(pBC, 0, sizeof(BC4_UNORM));
+    auto pBC4 = reinterpret_cast<BC4_UNORM*>(pBC);
+
+    pBC4->red_0 = pBC4->red_1 = FloatToUNorm(XMVectorGetX(pColor[0]));
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeSolidBC4S(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
+{
+    UNREFERENCED_PARAMETER(flags);
+
+    assert(pBC && pColor);
+    static_assert(sizeof(BC4_SNORM) == 8, "BC4_SNORM should be 8 bytes");
+
+    memset(pBC, 0, sizeof(BC4_SNORM));
+    auto pBC4 = reinterpret_cast<BC4_SNORM*>(pBC);
+
+    FloatToSNorm(XMVectorGetX(pColor[0]), &pBC4->red_0);
+    pBC4->red_1 = pBC4->red_0;
+}
+
 
 //-------------------------------------------------------------------------------------
 // BC5 Compression
@@ -477,6 +644,33 @@ void DirectX::D3DXDecodeBC5U(XMVECTOR *pColor, const uint8_t *pBC) noexcept
     }
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC5UToR8G8(PackedVector::XMUBYTEN2 *pColor, const uint8_t *pBC, size_t count) noexcept
+{
+    assert(pColor && pBC);
+    static_assert(sizeof(BC4_UNORM) == 8, "BC4_UNORM should be 8 bytes");
+
+    for (size_t j = 0; j < count; ++j)
+    {
+        auto pBCR = reinterpret_cast<const BC4_UNORM*>(pBC + j * 2 * sizeof(BC4_UNORM));
+        auto pBCG = reinterpret_cast<const BC4_UNORM*>(pBC + (j * 2 + 1) * sizeof(BC4_UNORM));
+
+        // Both palettes are converted together, the same way StoreScanline writes DXGI_FORMAT_R8G8_UNORM
+        PackedVector::XMUBYTEN2 aPalette[8];
+        for (size_t k = 0; k < 8; ++k)
+        {
+            PackedVector::XMStoreUByteN2(&aPalette[k], XMVectorSet(pBCR->DecodeFromIndex(k), pBCG->DecodeFromIndex(k), 0, 1.0f));
+        }
+
+        PackedVector::XMUBYTEN2* pBlock = &pColor[j * NUM_PIXELS_PER_BLOCK];
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            pBlock[i].x = aPalette[pBCR->GetIndex(i)].x;
+            pBlock[i].y = aPalette[pBCG->GetIndex(i)].y;
+        }
+    }
+}
+
 _Use_decl_annotations_
 void DirectX::D3DXDecodeBC5S(XMVECTOR *pColor, const uint8_t *pBC) noexcept
 {
@@ -496,8 +690,6 @@ void DirectX::D3DXDecodeBC5S(XMVECTOR *pColor, const uint8_t *pBC) noexcept
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC5U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
-
     assert(pBC && pColor);
     static_assert(sizeof(BC4_UNORM) == 8, "BC4_UNORM should be 8 bytes");
 
@@ -521,7 +713,8 @@ void DirectX::D3DXEncodeBC5U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
         pBCR->red_0,
         pBCR->red_1,
         pBCG->red_0,
-        pBCG->red_1);
+        pBCG->red_1,
+        flags);
 
     FindClosestUNORM(pBCR, theTexelsU);
     FindClosestUNORM(pBCG, theTexelsV);
@@ -530,8 +723,6 @@ void DirectX::D3DXEncodeBC5U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC5S(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
-
     assert(pBC && pColor);
     static_assert(sizeof(BC4_SNORM) == 8, "BC4_SNORM should be 8 bytes");
 
@@ -555,8 +746,50 @@ void DirectX::D3DXEncodeBC5S(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
         pBCR->red_0,
         pBCR->red_1,
         pBCG->red_0,
-        pBCG->red_1);
+        pBCG->red_1,
+        flags);
 
     FindClosestSNORM(pBCR, theTexelsU);
     FindClosestSNORM(pBCG, theTexelsV);
 }
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeSolidBC5U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
+{
+    UNREFERENCED_PARAMETER(flags);
+
+    assert(pBC && pColor);
+    static_assert(sizeof(BC4_UNORM) == 8, "BC4_UNORM should be 8 bytes");
+
+    memset(pBC, 0, sizeof(BC4_UNORM) * 2);
+    auto pBCR = reinterpret_cast<BC4_UNORM*>(pBC);
+    auto pBCG = reinterpret_cast<BC4_UNORM*>(pBC + sizeof(BC4_UNORM));
+
+    XMFLOAT4A clr;
+    XMStoreFloat4A(&clr, pColor[0]);
+
+    pBCR->red_0 = pBCR->red_1 = FloatToUNorm(clr.x);
+    pBCG->red_0 = pBCG->red_1 = FloatToUNorm(clr.y);
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeSolidBC5S(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
+{
+    UNREFERENCED_PARAMETER(flags);
+
+    assert(pBC && pColor);
+    static_assert(sizeof(BC4_SNORM) == 8, "BC4_SNORM should be 8 bytes");
+
+    memset(pBC, 0, sizeof(BC4_SNORM) * 2);
+    auto pBCR = reinterpret_cast<BC4_SNORM*>(pBC);
+    auto pBCG = reinterpret_cast<BC4_SNORM*>(pBC + sizeof(BC4_SNORM));
+
+    XMFLOAT4A clr;
+    XMStoreFloat4A(&clr, pColor[0]);
+
+    FloatToSNorm(clr.x, &pBCR->red_0);
+    pBCR->red_1 = pBCR->red_0;
+
+    FloatToSNorm(clr.y, &pBCG->red_0);
+    pBCG->red_1 = pBCG->red_0;
+}
@@ -261,7 +261,68 @@ namespace
         }
     };
 
-    // Partition, Shape, Fixup
+        // Partition, Shape, Subset: bit i is set when pixel i belongs to the subset
+    const uint16_t g_aPartitionMask[3][64][3] =
+    {
+        {   // 1 Region case has no subsets (all 0)
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },
+            { 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 },{ 0xFFFF, 0x0000, 0x0000 }
+        },
+
+        {   // BC6H/BC7 Partition Set for 2 Subsets
+            { 0x3333, 0xCCCC, 0x0000 },{ 0x7777, 0x8888, 0x0000 },{ 0x1111, 0xEEEE, 0x0000 },{ 0x1337, 0xECC8, 0x0000 },
+            { 0x377F, 0xC880, 0x0000 },{ 0x0113, 0xFEEC, 0x0000 },{ 0x0137, 0xFEC8, 0x0000 },{ 0x137F, 0xEC80, 0x0000 },
+            { 0x37FF, 0xC800, 0x0000 },{ 0x0013, 0xFFEC, 0x0000 },{ 0x017F, 0xFE80, 0x0000 },{ 0x17FF, 0xE800, 0x0000 },
+            { 0x0017, 0xFFE8, 0x0000 },{ 0x00FF, 0xFF00, 0x0000 },{ 0x000F, 0xFFF0, 0x0000 },{ 0x0FFF, 0xF000, 0x0000 },
+            { 0x08EF, 0xF710, 0x0000 },{ 0xFF71, 0x008E, 0x0000 },{ 0x8EFF, 0x7100, 0x0000 },{ 0xF731, 0x08CE, 0x0000 },
+            { 0xFF73, 0x008C, 0x0000 },{ 0x8CEF, 0x7310, 0x0000 },{ 0xCEFF, 0x3100, 0x0000 },{ 0x7331, 0x8CCE, 0x0000 },
+            { 0xF773, 0x088C, 0x0000 },{ 0xCEEF, 0x3110, 0x0000 },{ 0x9999, 0x6666, 0x0000 },{ 0xC993, 0x366C, 0x0000 },
+            { 0xE817, 0x17E8, 0x0000 },{ 0xF00F, 0x0FF0, 0x0000 },{ 0x8E71, 0x718E, 0x0000 },{ 0xC663, 0x399C, 0x0000 },
+            { 0x5555, 0xAAAA, 0x0000 },{ 0x0F0F, 0xF0F0, 0x0000 },{ 0xA5A5, 0x5A5A, 0x0000 },{ 0xCC33, 0x33CC, 0x0000 },
+            { 0xC3C3, 0x3C3C, 0x0000 },{ 0xAA55, 0x55AA, 0x0000 },{ 0x6969, 0x9696, 0x0000 },{ 0x5AA5, 0xA55A, 0x0000 },
+            { 0x8C31, 0x73CE, 0x0000 },{ 0xEC37, 0x13C8, 0x0000 },{ 0xCDB3, 0x324C, 0x0000 },{ 0xC423, 0x3BDC, 0x0000 },
+            { 0x9669, 0x6996, 0x0000 },{ 0x3CC3, 0xC33C, 0x0000 },{ 0x6699, 0x9966, 0x0000 },{ 0xF99F, 0x0660, 0x0000 },
+            { 0xFD8D, 0x0272, 0x0000 },{ 0xFB1B, 0x04E4, 0x0000 },{ 0xB1BF, 0x4E40, 0x0000 },{ 0xD8DF, 0x2720, 0x0000 },
+            { 0x36C9, 0xC936, 0x0000 },{ 0x6C93, 0x936C, 0x0000 },{ 0xC639, 0x39C6, 0x0000 },{ 0x9C63, 0x639C, 0x0000 },
+            { 0x6CC9, 0x9336, 0x0000 },{ 0x6339, 0x9CC6, 0x0000 },{ 0x7E81, 0x817E, 0x0000 },{ 0x18E7, 0xE718, 0x0000 },
+            { 0x330F, 0xCCF0, 0x0000 },{ 0xF033, 0x0FCC, 0x0000 },{ 0x88BB, 0x7744, 0x0000 },{ 0x11DD, 0xEE22, 0x0000 }
+        },
+
+        {   // BC7 Partition Set for 3 Subsets
+            { 0x0133, 0x08CC, 0xF600 },{ 0x0037, 0x8CC8, 0x7300 },{ 0x006F, 0xCC80, 0x3310 },{ 0x1331, 0xEC00, 0x00CE },
+            { 0x00FF, 0x3300, 0xCC00 },{ 0x3333, 0x00CC, 0xCC00 },{ 0x0033, 0xFF00, 0x00CC },{ 0x0033, 0xCCCC, 0x3300 },
+            { 0x00FF, 0x0F00, 0xF000 },{ 0x000F, 0x0FF0, 0xF000 },{ 0x000F, 0x00F0, 0xFF00 },{ 0x3333, 0x4444, 0x8888 },
+            { 0x1111, 0x6666, 0x8888 },{ 0x1111, 0x2222, 0xCCCC },{ 0x0013, 0x136C, 0xEC80 },{ 0x8C63, 0x008C, 0x7310 },
+            { 0x0137, 0x36C8, 0xC800 },{ 0xC631, 0x08CE, 0x3100 },{ 0x000F, 0x3330, 0xCCC0 },{ 0x0333, 0xF000, 0x0CCC },
+            { 0x1111, 0x00EE, 0xEE00 },{ 0x0077, 0x8888, 0x7700 },{ 0x113F, 0x22C0, 0xCC00 },{ 0x88CF, 0x4430, 0x3300 },
+            { 0xF311, 0x0C22, 0x00CC },{ 0x0033, 0x0344, 0xFC88 },{ 0x9009, 0x6996, 0x0660 },{ 0x009F, 0x9960, 0x6600 },
+            { 0x3443, 0x0330, 0xC88C },{ 0x0699, 0x0066, 0xF900 },{ 0x3113, 0xC22C, 0x0CC0 },{ 0x00EF, 0x8C00, 0x7310 },
+            { 0x007F, 0x1300, 0xEC80 },{ 0x3331, 0xC400, 0x08CE },{ 0x1333, 0x004C, 0xEC80 },{ 0x9999, 0x2222, 0x4444 },
+            { 0xF00F, 0x00F0, 0x0F00 },{ 0x9249, 0x2492, 0x4924 },{ 0x9429, 0x2942, 0x4294 },{ 0x30C3, 0xC30C, 0x0C30 },
+            { 0x3C03, 0xC03C, 0x03C0 },{ 0x0055, 0x00AA, 0xFF00 },{ 0x00FF, 0xAA00, 0x5500 },{ 0x0303, 0x3030, 0xCCCC },
+            { 0x3333, 0xC0C0, 0x0C0C },{ 0x0909, 0x9090, 0x6666 },{ 0x5005, 0xA00A, 0x0FF0 },{ 0x000F, 0xAAA0, 0x5550 },
+            { 0x0555, 0x0AAA, 0xF000 },{ 0x1111, 0xE0E0, 0x0E0E },{ 0x0707, 0x7070, 0x8888 },{ 0x000F, 0x6660, 0x9990 },
+            { 0x1111, 0x0EE0, 0xE00E },{ 0x7007, 0x0770, 0x8888 },{ 0x0999, 0x0666, 0xF000 },{ 0x00FF, 0x6600, 0x9900 },
+            { 0x0099, 0x0066, 0xFF00 },{ 0x3333, 0x0CC0, 0xC00C },{ 0x3003, 0x0330, 0xCCCC },{ 0x0FFF, 0x6000, 0x9000 },
+            { 0x7777, 0x8080, 0x0808 },{ 0x0101, 0x1010, 0xEEEE },{ 0x0005, 0x000A, 0xFFF0 },{ 0x8421, 0x08CE, 0x7310 }
+        }
+    };
+
+// Partition, Shape, Fixup
     const uint8_t g_aFixUp[3][64][3] =
     {
         {   // No fix-ups for 1st subset for BC6H or BC7
@@ -502,6 +563,11 @@ namespace
             const XMVECTOR v = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&c));
             XMStoreHalf4(&aF16, v);
 
+            Set(aF16, bSigned);
+        }
+
+        void Set(_In_ const PackedVector::XMHALF4& aF16, _In_ bool bSigned) noexcept
+        {
             r = F16ToINT(aF16.x, bSigned);
             g = F16ToINT(aF16.y, bSigned);
             b = F16ToINT(aF16.z, bSigned);
@@ -667,7 +733,9 @@ namespace
     {
     public:
         void Decode(_In_ bool bSigned, _Out_writes_(NUM_PIXELS_PER_BLOCK) HDRColorA* pOut) const noexcept;
-        void Encode(_In_ bool bSigned, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn) noexcept;
+        void Decode(_In_ bool bSigned, _Out_writes_(NUM_PIXELS_PER_BLOCK) PackedVector::XMHALF4* pOut) const noexcept;
+        void Encode(_In_ bool bSigned, _In_ uint32_t flags, _In_ float fErrorTarget, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn) noexcept;
+        void Encode(_In_ bool bSigned, _In_ uint32_t flags, _In_ float fErrorTarget, _In_reads_(NUM_PIXELS_PER_BLOCK) const PackedVector::XMHALF4* const pIn) noexcept;
 
     private:
     #pragma warning(push)
@@ -727,9 +795,33 @@ namespace
                     aIPixels[i].Set(aOriginal[i], bSigned);
                 }
             }
+
+            EncodeParams(const HDRColorA* const aOriginal, const PackedVector::XMHALF4* const aHalf, bool bSignedFormat) noexcept :
+                fBestErr(FLT_MAX), bSigned(bSignedFormat), uMode(0), uShape(0), aHDRPixels(aOriginal), aUnqEndPts{}, aIPixels{}
+            {
+                for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+                {
+                    aIPixels[i].Set(aHalf[i], bSigned);
+                }
+            }
         };
     #pragma warning(pop)
 
+        // The pixels of one region in SoA layout, four pixels per vector, so the endpoint search can
+        // match every pixel against a palette entry at once. Padding lanes have a weight of zero.
+        struct RegionPixels
+        {
+            XMVECTOR r[NUM_PIXELS_PER_BLOCK / 4];
+            XMVECTOR g[NUM_PIXELS_PER_BLOCK / 4];
+            XMVECTOR b[NUM_PIXELS_PER_BLOCK / 4];
+            XMVECTOR weight[NUM_PIXELS_PER_BLOCK / 4];
+            size_t uGroups;
+
+            RegionPixels(_In_reads_(np) const INTColor aColors[], _In_ size_t np) noexcept;
+        };
+
+        void Encode(_Inout_ EncodeParams* pEP, _In_ uint32_t flags, _In_ float fErrorTarget) noexcept;
+
         static int Quantize(_In_ int iValue, _In_ int prec, _In_ bool bSigned) noexcept;
         static int Unquantize(_In_ int comp, _In_ uint8_t uBitsPerComp, _In_ bool bSigned) noexcept;
         static int FinishUnquantize(_In_ int comp, _In_ bool bSigned) noexcept;
@@ -738,10 +830,10 @@ namespace
 
         void GeneratePaletteQuantized(_In_ const EncodeParams* pEP, _In_ const INTEndPntPair& endPts,
             _Out_writes_(BC6H_MAX_INDICES) INTColor aPalette[]) const noexcept;
-        float MapColorsQuantized(_In_ const EncodeParams* pEP, _In_reads_(np) const INTColor aColors[], _In_ size_t np, _In_ const INTEndPntPair &endPts) const noexcept;
-        float PerturbOne(_In_ const EncodeParams* pEP, _In_reads_(np) const INTColor aColors[], _In_ size_t np, _In_ uint8_t ch,
+        float MapColorsQuantized(_In_ const EncodeParams* pEP, _In_ const RegionPixels& pixels, _In_ const INTEndPntPair &endPts) const noexcept;
+        float PerturbOne(_In_ const EncodeParams* pEP, _In_ const RegionPixels& pixels, _In_ uint8_t ch,
             _In_ const INTEndPntPair& oldEndPts, _Out_ INTEndPntPair& newEndPts, _In_ float fOldErr, _In_ int do_b) const noexcept;
-        void OptimizeOne(_In_ const EncodeParams* pEP, _In_reads_(np) const INTColor aColors[], _In_ size_t np, _In_ float aOrgErr,
+        void OptimizeOne(_In_ const EncodeParams* pEP, _In_ const RegionPixels& pixels, _In_ float aOrgErr,
             _In_ const INTEndPntPair &aOrgEndPts, _Out_ INTEndPntPair &aOptEndPts) const noexcept;
         void OptimizeEndPoints(_In_ const EncodeParams* pEP, _In_reads_(BC6H_MAX_REGIONS) const float aOrgErr[],
             _In_reads_(BC6H_MAX_REGIONS) const INTEndPntPair aOrgEndPts[],
@@ -767,6 +859,8 @@ namespace
         static const ModeDescriptor ms_aDesc[c_NumModes][82];
         static const ModeInfo ms_aInfo[c_NumModes];
         static const int ms_aModeToInfo[c_NumModeInfo];
+        static const uint8_t ms_aModeOrder[2][c_NumModes];
+        static const uint8_t ms_aQuickModes[2][3];
     };
 
     // BC67 compression (16b bits per texel)
@@ -774,7 +868,12 @@ namespace
     {
     public:
         void Decode(_Out_writes_(NUM_PIXELS_PER_BLOCK) HDRColorA* pOut) const noexcept;
-        void Encode(uint32_t flags, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn) noexcept;
+        void Decode(_Out_writes_(NUM_PIXELS_PER_BLOCK) LDRColorA* pOut) const noexcept;
+        void Encode(uint32_t flags, _In_ float fErrorTarget, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn) noexcept;
+        void Encode(uint32_t flags, _In_ float fErrorTarget, _In_reads_(NUM_PIXELS_PER_BLOCK) const PackedVector::XMUBYTEN4* const pIn) noexcept;
+
+        static void EncodeBatch(uint32_t flags, _In_ float fErrorTarget, _In_reads_(NUM_PIXELS_PER_BLOCK * NUM_BLOCKS_PER_BATCH) const HDRColorA* const pIn,
+            _Out_writes_(NUM_BLOCKS_PER_BATCH) D3DX_BC7* pOut) noexcept;
 
     private:
         struct ModeInfo
@@ -799,14 +898,45 @@ namespace
             LDRColorA aLDRPixels[NUM_PIXELS_PER_BLOCK];
             const HDRColorA* const aHDRPixels;
 
-            EncodeParams(const HDRColorA* const aOriginal) noexcept : uMode(0), aEndPts{}, aLDRPixels{}, aHDRPixels(aOriginal) {}
+            EncodeParams(const HDRColorA* const aOriginal) noexcept : uMode(0), aEndPts{}, aLDRPixels{}, aHDRPixels(aOriginal)
+            {
+                for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+                {
+                    aLDRPixels[i].r = uint8_t(std::max<float>(0.0f, std::min<float>(255.0f, aOriginal[i].r * 255.0f + 0.01f)));
+                    aLDRPixels[i].g = uint8_t(std::max<float>(0.0f, std::min<float>(255.0f, aOriginal[i].g * 255.0f + 0.01f)));
+                    aLDRPixels[i].b = uint8_t(std::max<float>(0.0f, std::min<float>(255.0f, aOriginal[i].b * 255.0f + 0.01f)));
+                    aLDRPixels[i].a = uint8_t(std::max<float>(0.0f, std::min<float>(255.0f, aOriginal[i].a * 255.0f + 0.01f)));
+                }
+            }
+
+            EncodeParams(const HDRColorA* const aOriginal, const PackedVector::XMUBYTEN4* const aBytes) noexcept :
+                uMode(0), aEndPts{}, aLDRPixels{}, aHDRPixels(aOriginal)
+            {
+                for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+                {
+                    aLDRPixels[i] = LDRColorA(aBytes[i].x, aBytes[i].y, aBytes[i].z, aBytes[i].w);
+                }
+            }
         };
     #pragma warning(pop)
 
+        void Encode(_Inout_ EncodeParams* pEP, uint32_t flags, _In_ float fErrorTarget) noexcept;
+
+        struct BlockAnalysis
+        {
+            float fAlphaErr;        // Error every mode without alpha (0-3) is bound to incur
+            uint8_t uModeMask;      // Modes worth searching
+            uint8_t uRotationMask;  // Rotations worth searching for modes 4 and 5
+        };
+
+        static void AnalyzeBlock(_In_ const EncodeParams* pEP, _In_ uint32_t flags, _Out_ BlockAnalysis* pAnalysis) noexcept;
+
         static uint8_t Quantize(_In_ uint8_t comp, _In_ uint8_t uPrec) noexcept
         {
             assert(0 < uPrec && uPrec <= 8);
-            const uint8_t rnd = std::min<uint8_t>(255u, static_cast<uint8_t>(unsigned(comp) + (1u << (7 - uPrec))));
+            if (uPrec >= 8)
+                return comp;
+            const unsigned rnd = std::min<unsigned>(255u, unsigned(comp) + (1u << (7 - uPrec)));
             return uint8_t(rnd >> (8u - uPrec));
         }
 
@@ -872,6 +1002,7 @@ namespace
         static constexpr uint8_t c_NumModes = 8;
 
         static const ModeInfo ms_aInfo[c_NumModes];
+        static const uint8_t ms_aModeOrder[2][c_NumModes];
     };
 }
 
@@ -1102,6 +1233,22 @@ const int D3DX_BC6H::ms_aModeToInfo[D3DX_BC6H::c_NumModeInfo] =
     -1, // Resreved - 0x1f
 };
 
+const uint8_t D3DX_BC6H::ms_aModeOrder[2][D3DX_BC6H::c_NumModes] =
+{
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 },
+        // Full search
+    { 10, 11, 12, 13, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 },
+        // Error target: search the single region modes first so the 32-shape two region modes can be skipped once the target is met
+};
+
+const uint8_t D3DX_BC6H::ms_aQuickModes[2][3] =
+{
+    { 10, 11, 13 },
+        // One region: 10-bit direct, 11-bit base with 9-bit deltas, 16-bit base with 4-bit deltas
+    { 1, 6, 9 },
+        // Two regions: 7-bit base with 6-bit deltas, 8-bit base with 6/5/5-bit deltas, 6-bit direct (always fits)
+};
+
 // BC7 compression: uPartitions, uPartitionBits, uPBits, uRotationBits, uIndexModeBits, uIndexPrec, uIndexPrec2, RGBAPrec, RGBAPrecWithP
 const D3DX_BC7::ModeInfo D3DX_BC7::ms_aInfo[D3DX_BC7::c_NumModes] =
 {
@@ -1123,6 +1270,16 @@ const D3DX_BC7::ModeInfo D3DX_BC7::ms_aInfo[D3DX_BC7::c_NumModes] =
         // Mode 7: Color+Alpha, 2 Subsets, RGBAP 55551 (unique P-bit), 2-bit indices, 64 partitions
 };
 
+const uint8_t D3DX_BC7::ms_aModeOrder[2][D3DX_BC7::c_NumModes] =
+{
+    { 0, 1, 2, 3, 4, 5, 6, 7 },
+        // Opaque blocks
+    { 6, 5, 4, 7, 0, 1, 2, 3 },
+        // Blocks with alpha or an error target: search the single subset modes first, so the color only modes can be
+        // rejected up front and the partitioned modes skipped once the target is met. Encode breaks ties in the order
+        // of the full search, so this picks the same encoding as the opaque order when there is no error target
+};
+
 
 namespace
 {
@@ -1635,16 +1792,32 @@ namespace
     }
 
 
-    void FillWithErrorColors(_Out_writes_(NUM_PIXELS_PER_BLOCK) HDRColorA* pOut) noexcept
+    void FillWithErrorColors(_Out_writes_(NUM_PIXELS_PER_BLOCK) XMHALF4* pOut) noexcept
+    {
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+        #ifdef _DEBUG
+            // Use Magenta in debug as a highly-visible error color
+            pOut[i].x = pOut[i].z = pOut[i].w = XMConvertFloatToHalf(1.0f);
+            pOut[i].y = 0;
+        #else
+            // In production use, default to black
+            pOut[i].x = pOut[i].y = pOut[i].z = 0;
+            pOut[i].w = XMConvertFloatToHalf(1.0f);
+        #endif
+        }
+    }
+
+    void FillWithErrorColors(_Out_writes_(NUM_PIXELS_PER_BLOCK) LDRColorA* pOut) noexcept
     {
         for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
         {
         #ifdef _DEBUG
             // Use Magenta in debug as a highly-visible error color
-            pOut[i] = HDRColorA(1.0f, 0.0f, 1.0f, 1.0f);
+            pOut[i] = LDRColorA(255, 0, 255, 255);
         #else
             // In production use, default to black
-            pOut[i] = HDRColorA(0.0f, 0.0f, 0.0f, 1.0f);
+            pOut[i] = LDRColorA(0, 0, 0, 255);
         #endif
         }
     }
@@ -1659,6 +1832,20 @@ void D3DX_BC6H::Decode(bool bSigned, HDRColorA* pOut) const noexcept
 {
     assert(pOut);
 
+    XMHALF4 aHalf[NUM_PIXELS_PER_BLOCK];
+    Decode(bSigned, aHalf);
+
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&pOut[i]), XMLoadHalf4(&aHalf[i]));
+    }
+}
+
+_Use_decl_annotations_
+void D3DX_BC6H::Decode(bool bSigned, XMHALF4* pOut) const noexcept
+{
+    assert(pOut);
+
     size_t uStartBit = 0;
     uint8_t uMode = GetBits(uStartBit, 2u);
     if (uMode != 0x00 && uMode != 0x01)
@@ -1784,10 +1971,10 @@ void D3DX_BC6H::Decode(bool bSigned, HDRColorA* pOut) const noexcept
             HALF rgb[3];
             fc.ToF16(rgb, bSigned);
 
-            pOut[i].r = XMConvertHalfToFloat(rgb[0]);
-            pOut[i].g = XMConvertHalfToFloat(rgb[1]);
-            pOut[i].b = XMConvertHalfToFloat(rgb[2]);
-            pOut[i].a = 1.0f;
+            pOut[i].x = rgb[0];
+            pOut[i].y = rgb[1];
+            pOut[i].z = rgb[2];
+            pOut[i].w = XMConvertFloatToHalf(1.0f);
         }
     }
     else
@@ -1807,21 +1994,93 @@ void D3DX_BC6H::Decode(bool bSigned, HDRColorA* pOut) const noexcept
         // Per the BC6H format spec, we must return opaque black
         for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
         {
-            pOut[i] = HDRColorA(0.0f, 0.0f, 0.0f, 1.0f);
+            pOut[i].x = pOut[i].y = pOut[i].z = 0;
+            pOut[i].w = XMConvertFloatToHalf(1.0f);
         }
     }
 }
 
 
 _Use_decl_annotations_
-void D3DX_BC6H::Encode(bool bSigned, const HDRColorA* const pIn) noexcept
+void D3DX_BC6H::Encode(bool bSigned, uint32_t flags, float fErrorTarget, const HDRColorA* const pIn) noexcept
 {
     assert(pIn);
 
     EncodeParams EP(pIn, bSigned);
+    Encode(&EP, flags, fErrorTarget);
+}
+
+_Use_decl_annotations_
+void D3DX_BC6H::Encode(bool bSigned, uint32_t flags, float fErrorTarget, const PackedVector::XMHALF4* const pIn) noexcept
+{
+    assert(pIn);
+
+    // The endpoint fit works on floats, but the integer pixels are taken from the half bits as-is
+    HDRColorA aColors[NUM_PIXELS_PER_BLOCK];
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&aColors[i]), XMLoadHalf4(&pIn[i]));
+    }
+
+    EncodeParams EP(aColors, pIn, bSigned);
+    Encode(&EP, flags, fErrorTarget);
+}
+
+_Use_decl_annotations_
+void D3DX_BC6H::Encode(EncodeParams* pEP, uint32_t flags, float fErrorTarget) noexcept
+{
+    assert(pEP);
+    assert(fErrorTarget >= 0.0f);
+
+    EncodeParams& EP = *pEP;
+
+    if (flags & BC_FLAGS_BC6H_QUICK)
+    {
+        // The unquantized endpoints only depend on the shape, so a single rough fit serves every one region mode
+        EP.uMode = ms_aQuickModes[0][0];
+        EP.uShape = 0;
+        RoughMSE(&EP);
+
+        for (size_t i = 0; i < std::size(ms_aQuickModes[0]) && EP.fBestErr > fErrorTarget; ++i)
+        {
+            EP.uMode = ms_aQuickModes[0][i];
+            Refine(&EP);
+        }
+
+        if (EP.fBestErr <= fErrorTarget)
+            return;
+
+        // All two region modes share 3-bit indices, so one pass ranks the shapes for all of them
+        EP.uMode = ms_aQuickModes[1][0];
+        float fRoughBest = FLT_MAX;
+        uint8_t uBestShape = 0;
+        for (EP.uShape = 0; EP.uShape < BC6H_MAX_SHAPES; ++EP.uShape)
+        {
+            const float fRoughMSE = RoughMSE(&EP);
+            if (fRoughMSE < fRoughBest)
+            {
+                fRoughBest = fRoughMSE;
+                uBestShape = EP.uShape;
+            }
+        }
+
+        // Refine only if the unquantized fit of the best shape beats the one region result
+        if (fRoughBest >= EP.fBestErr)
+            return;
 
-    for (EP.uMode = 0; EP.uMode < c_NumModes && EP.fBestErr > 0; ++EP.uMode)
+        EP.uShape = uBestShape;
+        for (size_t i = 0; i < std::size(ms_aQuickModes[1]) && EP.fBestErr > fErrorTarget; ++i)
+        {
+            EP.uMode = ms_aQuickModes[1][i];
+            Refine(&EP);
+        }
+        return;
+    }
+
+    for (size_t iMode = 0; iMode < c_NumModes && EP.fBestErr > fErrorTarget; ++iMode)
     {
+        EP.uMode = ms_aModeOrder[(fErrorTarget > 0.0f) ? 1 : 0][iMode];
+
         const uint8_t uShapes = ms_aInfo[EP.uMode].uPartitions ? 32u : 1u;
         // Number of rough cases to look at. reasonable values of this are 1, uShapes/4, and uShapes
         // uShapes/4 gets nearly all the cases; you can increase that a bit (say by 3 or 4) if you really want to squeeze the last bit out
@@ -1850,7 +2109,7 @@ void D3DX_BC6H::Encode(bool bSigned, const HDRColorA* const pIn) noexcept
             }
         }
 
-        for (size_t i = 0; i < uItems && EP.fBestErr > 0; i++)
+        for (size_t i = 0; i < uItems && EP.fBestErr > fErrorTarget; i++)
         {
             EP.uShape = auShape[i];
             Refine(&EP);
@@ -1926,6 +2185,32 @@ int D3DX_BC6H::Unquantize(int comp, uint8_t uBitsPerComp, bool bSigned) noexcept
 }
 
 
+_Use_decl_annotations_
+D3DX_BC6H::RegionPixels::RegionPixels(const INTColor aColors[], size_t np) noexcept :
+    uGroups((np + 3) >> 2)
+{
+    assert(np > 0 && np <= NUM_PIXELS_PER_BLOCK);
+
+    for (size_t j = 0; j < uGroups; ++j)
+    {
+        XMVECTORF32 vr, vg, vb, vw;
+        for (size_t k = 0; k < 4; ++k)
+        {
+            const size_t i = j * 4 + k;
+            const INTColor& c = aColors[(i < np) ? i : 0];
+            vr.f[k] = float(c.r);
+            vg.f[k] = float(c.g);
+            vb.f[k] = float(c.b);
+            vw.f[k] = (i < np) ? 1.f : 0.f;
+        }
+
+        r[j] = vr;
+        g[j] = vg;
+        b[j] = vb;
+        weight[j] = vw;
+    }
+}
+
 _Use_decl_annotations_
 int D3DX_BC6H::FinishUnquantize(int comp, bool bSigned) noexcept
 {
@@ -2000,13 +2285,16 @@ void D3DX_BC6H::GeneratePaletteQuantized(const EncodeParams* pEP, const INTEndPn
     const LDRColorA& Prec = ms_aInfo[pEP->uMode].RGBAPrec[0][0];
 
     // scale endpoints
-    INTEndPntPair unqEndPts;
-    unqEndPts.A.r = Unquantize(endPts.A.r, Prec.r, pEP->bSigned);
-    unqEndPts.A.g = Unquantize(endPts.A.g, Prec.g, pEP->bSigned);
-    unqEndPts.A.b = Unquantize(endPts.A.b, Prec.b, pEP->bSigned);
-    unqEndPts.B.r = Unquantize(endPts.B.r, Prec.r, pEP->bSigned);
-    unqEndPts.B.g = Unquantize(endPts.B.g, Prec.g, pEP->bSigned);
-    unqEndPts.B.b = Unquantize(endPts.B.b, Prec.b, pEP->bSigned);
+    const XMVECTOR unqA = XMVectorSet(
+        float(Unquantize(endPts.A.r, Prec.r, pEP->bSigned)),
+        float(Unquantize(endPts.A.g, Prec.g, pEP->bSigned)),
+        float(Unquantize(endPts.A.b, Prec.b, pEP->bSigned)),
+        0.f);
+    const XMVECTOR unqB = XMVectorSet(
+        float(Unquantize(endPts.B.r, Prec.r, pEP->bSigned)),
+        float(Unquantize(endPts.B.g, Prec.g, pEP->bSigned)),
+        float(Unquantize(endPts.B.b, Prec.b, pEP->bSigned)),
+        0.f);
 
     // interpolate
     const int* aWeights = nullptr;
@@ -2024,61 +2312,81 @@ void D3DX_BC6H::GeneratePaletteQuantized(const EncodeParams* pEP, const INTEndPn
         return;
     }
 
+    // Unquantized endpoints are at most 16 bits, so the weighted sums are exact in float. The shift is a floor,
+    // and FinishUnquantize scales the magnitude by 31/32 (signed) or 31/64 (unsigned), which truncates
+    const XMVECTOR vRound = XMVectorReplicate(float(BC67_WEIGHT_ROUND));
+    const float fFinish = pEP->bSigned ? (31.f / 32.f) : (31.f / 64.f);
     for (size_t i = 0; i < uNumIndices; ++i)
     {
-        aPalette[i].r = FinishUnquantize(
-            (unqEndPts.A.r * (BC67_WEIGHT_MAX - aWeights[i]) + unqEndPts.B.r * aWeights[i] + BC67_WEIGHT_ROUND) >> BC67_WEIGHT_SHIFT,
-            pEP->bSigned);
-        aPalette[i].g = FinishUnquantize(
-            (unqEndPts.A.g * (BC67_WEIGHT_MAX - aWeights[i]) + unqEndPts.B.g * aWeights[i] + BC67_WEIGHT_ROUND) >> BC67_WEIGHT_SHIFT,
-            pEP->bSigned);
-        aPalette[i].b = FinishUnquantize(
-            (unqEndPts.A.b * (BC67_WEIGHT_MAX - aWeights[i]) + unqEndPts.B.b * aWeights[i] + BC67_WEIGHT_ROUND) >> BC67_WEIGHT_SHIFT,
-            pEP->bSigned);
+        XMVECTOR v = XMVectorMultiplyAdd(unqA, XMVectorReplicate(float(BC67_WEIGHT_MAX - aWeights[i])), vRound);
+        v = XMVectorMultiplyAdd(unqB, XMVectorReplicate(float(aWeights[i])), v);
+        v = XMVectorFloor(XMVectorScale(v, 1.f / float(1u << BC67_WEIGHT_SHIFT)));
+        v = XMVectorTruncate(XMVectorScale(v, fFinish));
+        XMStoreSInt4(reinterpret_cast<XMINT4*>(&aPalette[i]), v);
     }
 }
 
 
 // given a collection of colors and quantized endpoints, generate a palette, choose best entries, and return a single toterr
 _Use_decl_annotations_
-float D3DX_BC6H::MapColorsQuantized(const EncodeParams* pEP, const INTColor aColors[], size_t np, const INTEndPntPair &endPts) const noexcept
+float D3DX_BC6H::MapColorsQuantized(const EncodeParams* pEP, const RegionPixels& pixels, const INTEndPntPair &endPts) const noexcept
 {
     assert(pEP);
     assert(pEP->uMode < c_NumModes);
     _Analysis_assume_(pEP->uMode < c_NumModes);
+    assert(pixels.uGroups > 0 && pixels.uGroups <= NUM_PIXELS_PER_BLOCK / 4);
+    _Analysis_assume_(pixels.uGroups <= NUM_PIXELS_PER_BLOCK / 4);
 
     const uint8_t uIndexPrec = ms_aInfo[pEP->uMode].uIndexPrec;
     const auto uNumIndices = static_cast<const uint8_t>(1u << uIndexPrec);
     INTColor aPalette[BC6H_MAX_INDICES];
     GeneratePaletteQuantized(pEP, endPts, aPalette);
 
-    float fTotErr = 0;
-    for (size_t i = 0; i < np; ++i)
+    // Compute ErrorMetricRGB of every pixel against every palette entry, keeping the smallest per pixel
+    XMVECTOR vBestErr[NUM_PIXELS_PER_BLOCK / 4];
+    for (size_t g = 0; g < pixels.uGroups; ++g)
     {
-        const XMVECTOR vcolors = XMLoadSInt4(reinterpret_cast<const XMINT4*>(&aColors[i]));
+        vBestErr[g] = g_XMFltMax;
+    }
 
-        // Compute ErrorMetricRGB
-        XMVECTOR tpal = XMLoadSInt4(reinterpret_cast<const XMINT4*>(&aPalette[0]));
-        tpal = XMVectorSubtract(vcolors, tpal);
-        float fBestErr = XMVectorGetX(XMVector3Dot(tpal, tpal));
+    for (size_t j = 0; j < uNumIndices; ++j)
+    {
+        const XMVECTOR tpal = XMLoadSInt4(reinterpret_cast<const XMINT4*>(&aPalette[j]));
+        const XMVECTOR palR = XMVectorSplatX(tpal);
+        const XMVECTOR palG = XMVectorSplatY(tpal);
+        const XMVECTOR palB = XMVectorSplatZ(tpal);
 
-        for (int j = 1; j < uNumIndices && fBestErr > 0; ++j)
+        for (size_t g = 0; g < pixels.uGroups; ++g)
         {
-            // Compute ErrorMetricRGB
-            tpal = XMLoadSInt4(reinterpret_cast<const XMINT4*>(&aPalette[j]));
-            tpal = XMVectorSubtract(vcolors, tpal);
-            const float fErr = XMVectorGetX(XMVector3Dot(tpal, tpal));
-            if (fErr > fBestErr) break;     // error increased, so we're done searching
-            if (fErr < fBestErr) fBestErr = fErr;
+            const XMVECTOR dr = XMVectorSubtract(pixels.r[g], palR);
+            const XMVECTOR dg = XMVectorSubtract(pixels.g[g], palG);
+            const XMVECTOR db = XMVectorSubtract(pixels.b[g], palB);
+
+            XMVECTOR vErr = XMVectorMultiply(dr, dr);
+            vErr = XMVectorMultiplyAdd(dg, dg, vErr);
+            vErr = XMVectorMultiplyAdd(db, db, vErr);
+            vBestErr[g] = XMVectorMin(vBestErr[g], vErr);
         }
-        fTotErr += fBestErr;
+    }
+
+    // Sum in pixel order, as the scalar loop did; padding lanes have a weight of zero
+    float aBestErr[NUM_PIXELS_PER_BLOCK];
+    for (size_t g = 0; g < pixels.uGroups; ++g)
+    {
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&aBestErr[g * 4]), XMVectorMultiply(vBestErr[g], pixels.weight[g]));
+    }
+
+    float fTotErr = 0;
+    for (size_t i = 0; i < pixels.uGroups * 4; ++i)
+    {
+        fTotErr += aBestErr[i];
     }
     return fTotErr;
 }
 
 
 _Use_decl_annotations_
-float D3DX_BC6H::PerturbOne(const EncodeParams* pEP, const INTColor aColors[], size_t np, uint8_t ch,
+float D3DX_BC6H::PerturbOne(const EncodeParams* pEP, const RegionPixels& pixels, uint8_t ch,
     const INTEndPntPair& oldEndPts, INTEndPntPair& newEndPts, float fOldErr, int do_b) const noexcept
 {
     assert(pEP);
@@ -2119,7 +2427,7 @@ float D3DX_BC6H::PerturbOne(const EncodeParams* pEP, const INTColor aColors[], s
                     continue;
             }
 
-            const float fErr = MapColorsQuantized(pEP, aColors, np, tmpEndPts);
+            const float fErr = MapColorsQuantized(pEP, pixels, tmpEndPts);
 
             if (fErr < fMinErr)
             {
@@ -2142,7 +2450,7 @@ float D3DX_BC6H::PerturbOne(const EncodeParams* pEP, const INTColor aColors[], s
 
 
 _Use_decl_annotations_
-void D3DX_BC6H::OptimizeOne(const EncodeParams* pEP, const INTColor aColors[], size_t np, float aOrgErr,
+void D3DX_BC6H::OptimizeOne(const EncodeParams* pEP, const RegionPixels& pixels, float aOrgErr,
     const INTEndPntPair &aOrgEndPts, INTEndPntPair &aOptEndPts) const noexcept
 {
     assert(pEP);
@@ -2159,8 +2467,8 @@ void D3DX_BC6H::OptimizeOne(const EncodeParams* pEP, const INTColor aColors[], s
     {
         // figure out which endpoint when perturbed gives the most improvement and start there
         // if we just alternate, we can easily end up in a local minima
-        const float fErr0 = PerturbOne(pEP, aColors, np, ch, aOptEndPts, new_a, aOptErr, 0);	// perturb endpt A
-        const float fErr1 = PerturbOne(pEP, aColors, np, ch, aOptEndPts, new_b, aOptErr, 1);	// perturb endpt B
+        const float fErr0 = PerturbOne(pEP, pixels, ch, aOptEndPts, new_a, aOptErr, 0);	// perturb endpt A
+        const float fErr1 = PerturbOne(pEP, pixels, ch, aOptEndPts, new_b, aOptErr, 1);	// perturb endpt B
 
         if (fErr0 < fErr1)
         {
@@ -2180,7 +2488,7 @@ void D3DX_BC6H::OptimizeOne(const EncodeParams* pEP, const INTColor aColors[], s
         // now alternate endpoints and keep trying until there is no improvement
         for (;;)
         {
-            const float fErr = PerturbOne(pEP, aColors, np, ch, aOptEndPts, newEndPts, aOptErr, do_b);
+            const float fErr = PerturbOne(pEP, pixels, ch, aOptEndPts, newEndPts, aOptErr, do_b);
             if (fErr >= aOptErr)
                 break;
             if (do_b == 0)
@@ -2212,13 +2520,14 @@ void D3DX_BC6H::OptimizeEndPoints(const EncodeParams* pEP, const float aOrgErr[]
         size_t np = 0;
         for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
         {
-            if (g_aPartitionTable[p][pEP->uShape][i] == p)
+            if (g_aPartitionTable[uPartitions][pEP->uShape][i] == p)
             {
                 aPixels[np++] = pEP->aIPixels[i];
             }
         }
 
-        OptimizeOne(pEP, aPixels, np, aOrgErr[p], aOrgEndPts[p], aOptEndPts[p]);
+        const RegionPixels pixels(aPixels, np);
+        OptimizeOne(pEP, pixels, aOrgErr[p], aOrgEndPts[p], aOptEndPts[p]);
     }
 }
 
@@ -2567,6 +2876,20 @@ void D3DX_BC7::Decode(HDRColorA* pOut) const noexcept
 {
     assert(pOut);
 
+    LDRColorA aColors[NUM_PIXELS_PER_BLOCK];
+    Decode(aColors);
+
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        pOut[i] = HDRColorA(aColors[i]);
+    }
+}
+
+_Use_decl_annotations_
+void D3DX_BC7::Decode(LDRColorA* pOut) const noexcept
+{
+    assert(pOut);
+
     size_t uFirst = 0;
     while (uFirst < 128 && !GetBit(uFirst)) {}
     const uint8_t uMode = uint8_t(uFirst - 1);
@@ -2766,7 +3089,7 @@ void D3DX_BC7::Decode(HDRColorA* pOut) const noexcept
             default: break;
             }
 
-            pOut[i] = HDRColorA(outPixel);
+            pOut[i] = outPixel;
         }
     }
     else
@@ -2775,33 +3098,201 @@ void D3DX_BC7::Decode(HDRColorA* pOut) const noexcept
         OutputDebugStringA("BC7: Reserved mode 8 encountered during decoding\n");
     #endif
         // Per the BC7 format spec, we must return transparent black
-        memset(pOut, 0, sizeof(HDRColorA) * NUM_PIXELS_PER_BLOCK);
+        memset(pOut, 0, sizeof(LDRColorA) * NUM_PIXELS_PER_BLOCK);
+    }
+}
+
+_Use_decl_annotations_
+void D3DX_BC7::AnalyzeBlock(const EncodeParams* pEP, uint32_t flags, BlockAnalysis* pAnalysis) noexcept
+{
+    assert(pEP && pAnalysis);
+
+    // Blocks whose off-axis error is below this are treated as a line segment by the fast search
+    static constexpr float c_fCollinearErr = 128.0f;
+
+    pAnalysis->fAlphaErr = 0.0f;
+    pAnalysis->uModeMask = 0xFF;
+    pAnalysis->uRotationMask = 0xF;
+
+    float afMean[4] = {};
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        const LDRColorA& c = pEP->aLDRPixels[i];
+        const float fA = float(255 - c.a);
+        pAnalysis->fAlphaErr += fA * fA;
+        for (size_t ch = 0; ch < 4; ++ch)
+        {
+            afMean[ch] += float(c[ch]);
+        }
+    }
+
+    if (!(flags & BC_FLAGS_EFFORT_FAST))
+        return;
+
+    // Covariance of the block, and its principal axis found by power iteration
+    float afCov[4][4] = {};
+    for (size_t ch = 0; ch < 4; ++ch)
+    {
+        afMean[ch] *= 1.0f / float(NUM_PIXELS_PER_BLOCK);
+    }
+
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        float afDiff[4];
+        for (size_t ch = 0; ch < 4; ++ch)
+        {
+            afDiff[ch] = float(pEP->aLDRPixels[i][ch]) - afMean[ch];
+        }
+
+        for (size_t j = 0; j < 4; ++j)
+        {
+            for (size_t k = j; k < 4; ++k)
+            {
+                afCov[j][k] += afDiff[j] * afDiff[k];
+            }
+        }
+    }
+
+    for (size_t j = 1; j < 4; ++j)
+    {
+        for (size_t k = 0; k < j; ++k)
+        {
+            afCov[j][k] = afCov[k][j];
+        }
+    }
+
+    size_t uMaxCh = 0;
+    for (size_t ch = 1; ch < 4; ++ch)
+    {
+        if (afCov[ch][ch] > afCov[uMaxCh][uMaxCh])
+            uMaxCh = ch;
+    }
+
+    const float fTotalErr = afCov[0][0] + afCov[1][1] + afCov[2][2] + afCov[3][3];
+    if (fTotalErr <= 0.0f)
+        return;
+
+    float afAxis[4] = { afCov[uMaxCh][0], afCov[uMaxCh][1], afCov[uMaxCh][2], afCov[uMaxCh][3] };
+    for (size_t iter = 0; iter < 8; ++iter)
+    {
+        float afNext[4] = {};
+        float fLen = 0.0f;
+        for (size_t j = 0; j < 4; ++j)
+        {
+            for (size_t k = 0; k < 4; ++k)
+            {
+                afNext[j] += afCov[j][k] * afAxis[k];
+            }
+            fLen += afNext[j] * afNext[j];
+        }
+
+        if (fLen <= 0.0f)
+            break;
+
+        fLen = 1.0f / sqrtf(fLen);
+        for (size_t j = 0; j < 4; ++j)
+        {
+            afAxis[j] = afNext[j] * fLen;
+        }
+    }
+
+    // Error left over by the best line through the block, in total and per channel
+    float afAxisErr[4];
+    float fAxisVar = 0.0f;
+    for (size_t j = 0; j < 4; ++j)
+    {
+        float fProj = 0.0f;
+        for (size_t k = 0; k < 4; ++k)
+        {
+            fProj += afCov[j][k] * afAxis[k];
+        }
+        fAxisVar += afAxis[j] * fProj;
+        afAxisErr[j] = afCov[j][j] - fProj * afAxis[j];
+    }
+
+    if (fTotalErr - fAxisVar < c_fCollinearErr)
+    {
+        // A single line already fits the block, so the partitioned modes have nothing left to gain
+        pAnalysis->uModeMask = (1u << 4) | (1u << 5) | (1u << 6);
+    }
+
+    // Besides the separate alpha of rotation 0, modes 4 and 5 only try to split off the channel that strays furthest from the line
+    size_t uRotation = 0;
+    for (size_t ch = 0; ch < 3; ++ch)
+    {
+        if (afAxisErr[ch] > afAxisErr[(uRotation + 3) & 3])
+            uRotation = ch + 1;
     }
+    pAnalysis->uRotationMask = uint8_t(1u | (1u << uRotation));
 }
 
 _Use_decl_annotations_
-void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
+void D3DX_BC7::Encode(uint32_t flags, float fErrorTarget, const HDRColorA* const pIn) noexcept
 {
     assert(pIn);
 
-    D3DX_BC7 final = *this;
     EncodeParams EP(pIn);
+    Encode(&EP, flags, fErrorTarget);
+}
+
+_Use_decl_annotations_
+void D3DX_BC7::Encode(uint32_t flags, float fErrorTarget, const PackedVector::XMUBYTEN4* const pIn) noexcept
+{
+    assert(pIn);
+
+    // The pixels are already 8-bit, only the rough fit and the block analysis need the float colors
+    HDRColorA aColors[NUM_PIXELS_PER_BLOCK];
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&aColors[i]), XMLoadUByteN4(&pIn[i]));
+    }
+
+    EncodeParams EP(aColors, pIn);
+    Encode(&EP, flags, fErrorTarget);
+}
+
+_Use_decl_annotations_
+void D3DX_BC7::Encode(EncodeParams* pEP, uint32_t flags, float fErrorTarget) noexcept
+{
+    assert(pEP);
+    assert(fErrorTarget >= 0.0f);
+
+    EncodeParams& EP = *pEP;
+    D3DX_BC7 final = *this;
     float fMSEBest = FLT_MAX;
     uint32_t alphaMask = 0xFF;
 
     for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
     {
-        EP.aLDRPixels[i].r = uint8_t(std::max<float>(0.0f, std::min<float>(255.0f, pIn[i].r * 255.0f + 0.01f)));
-        EP.aLDRPixels[i].g = uint8_t(std::max<float>(0.0f, std::min<float>(255.0f, pIn[i].g * 255.0f + 0.01f)));
-        EP.aLDRPixels[i].b = uint8_t(std::max<float>(0.0f, std::min<float>(255.0f, pIn[i].b * 255.0f + 0.01f)));
-        EP.aLDRPixels[i].a = uint8_t(std::max<float>(0.0f, std::min<float>(255.0f, pIn[i].a * 255.0f + 0.01f)));
         alphaMask &= EP.aLDRPixels[i].a;
     }
 
     const bool bHasAlpha = (alphaMask != 0xFF);
 
-    for (EP.uMode = 0; EP.uMode < 8 && fMSEBest > 0; ++EP.uMode)
+    BlockAnalysis analysis;
+    AnalyzeBlock(&EP, flags, &analysis);
+
+    // Ties on error go to the candidate that comes first in the full search (by mode, rotation, index mode and
+    // shape rank), so the mode order does not change which encoding wins. Without an error target, finding a
+    // lossless encoding only ends the search for the candidates that come after it.
+    uint32_t uBestKey = UINT32_MAX;
+    auto fnSearching = [&]() noexcept -> bool
     {
+        return (fMSEBest > fErrorTarget) || ((fErrorTarget <= 0.0f) && (EP.uMode < (uBestKey >> 12)));
+    };
+
+    for (size_t iMode = 0; iMode < c_NumModes; ++iMode)
+    {
+        EP.uMode = ms_aModeOrder[(bHasAlpha || fErrorTarget > 0.0f) ? 1 : 0][iMode];
+
+        if (!fnSearching())
+        {
+            if (fErrorTarget > 0.0f)
+                break;
+
+            continue;
+        }
+
         if (!(flags & BC_FLAGS_USE_3SUBSETS) && (EP.uMode == 0 || EP.uMode == 2))
         {
             // 3 subset modes tend to be used rarely and add significant compression time
@@ -2820,6 +3311,18 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
             continue;
         }
 
+        if (!(analysis.uModeMask & (1u << EP.uMode)))
+        {
+            // The block analysis determined this mode cannot improve on the others
+            continue;
+        }
+
+        if (!ms_aInfo[EP.uMode].RGBAPrec.a && (analysis.fAlphaErr > fMSEBest))
+        {
+            // Color only modes decode alpha as 255, so the alpha error alone already rules them out
+            continue;
+        }
+
         const size_t uShapes = size_t(1) << ms_aInfo[EP.uMode].uPartitionBits;
         assert(uShapes <= BC7_MAX_SHAPES);
         _Analysis_assume_(uShapes <= BC7_MAX_SHAPES);
@@ -2832,8 +3335,11 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
         float afRoughMSE[BC7_MAX_SHAPES];
         size_t auShape[BC7_MAX_SHAPES];
 
-        for (size_t r = 0; r < uNumRots && fMSEBest > 0; ++r)
+        for (size_t r = 0; r < uNumRots && fnSearching(); ++r)
         {
+            if ((uNumRots > 1) && !(analysis.uRotationMask & (1u << r)))
+                continue;
+
             switch (r)
             {
             case 1: for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; i++) std::swap(EP.aLDRPixels[i].r, EP.aLDRPixels[i].a); break;
@@ -2842,7 +3348,7 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
             default: break;
             }
 
-            for (size_t im = 0; im < uNumIdxMode && fMSEBest > 0; ++im)
+            for (size_t im = 0; im < uNumIdxMode && fnSearching(); ++im)
             {
                 // pick the best uItems shapes and refine these.
                 for (size_t s = 0; s < uShapes; s++)
@@ -2864,13 +3370,15 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
                     }
                 }
 
-                for (size_t i = 0; i < uItems && fMSEBest > 0; i++)
+                for (size_t i = 0; i < uItems && fnSearching(); i++)
                 {
                     const float fMSE = Refine(&EP, auShape[i], r, im);
-                    if (fMSE < fMSEBest)
+                    const uint32_t uKey = (uint32_t(EP.uMode) << 12) | (uint32_t(r) << 8) | (uint32_t(im) << 4) | uint32_t(i);
+                    if (fMSE < fMSEBest || (fMSE == fMSEBest && uKey < uBestKey))
                     {
                         final = *this;
                         fMSEBest = fMSE;
+                        uBestKey = uKey;
                     }
                 }
             }
@@ -3512,10 +4020,11 @@ float D3DX_BC7::RoughMSE(EncodeParams* pEP, size_t uShape, size_t uIndexMode) no
 
     for (size_t p = 0; p <= uPartitions; p++)
     {
+        const uint32_t uMask = g_aPartitionMask[uPartitions][uShape][p];
         size_t np = 0;
         for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; i++)
         {
-            if (g_aPartitionTable[uPartitions][uShape][i] == p)
+            if (uMask & (1u << i))
             {
                 auPixIdx[np++] = i;
             }
@@ -3597,19 +4106,714 @@ float D3DX_BC7::RoughMSE(EncodeParams* pEP, size_t uShape, size_t uIndexMode) no
 }
 
 
-//=====================================================================================
-// Entry points
-//=====================================================================================
-
 //-------------------------------------------------------------------------------------
-// BC6H Compression
+// BC7 multi-block compression
 //-------------------------------------------------------------------------------------
-_Use_decl_annotations_
-void DirectX::D3DXDecodeBC6HU(XMVECTOR *pColor, const uint8_t *pBC) noexcept
+namespace
 {
-    assert(pColor && pBC);
-    static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
-    reinterpret_cast<const D3DX_BC6H*>(pBC)->Decode(false, reinterpret_cast<HDRColorA*>(pColor));
+    // Number of 2 subset shapes per block that are fitted with both mode 1 and mode 3
+    constexpr size_t BC7_BATCH_SHAPES = 4;
+
+    // Number of best candidates per block that go through endpoint refinement
+    constexpr size_t BC7_BATCH_REFINE = 1;
+
+    struct BC7BatchCandidate
+    {
+        float fErr;
+        uint8_t uMode;
+        uint8_t uShape;
+        uint8_t uRotation;
+        LDREndPntPair aEndPts[BC7_MAX_REGIONS];
+    };
+
+    inline XMVECTOR UnquantizeBatch(FXMVECTOR vQ, size_t uPrec) noexcept
+    {
+        // Same as D3DX_BC7::Unquantize: (q << (8 - uPrec)) | (q >> (2 * uPrec - 8))
+        const XMVECTOR vHigh = XMVectorScale(vQ, float(1u << (8 - uPrec)));
+        const XMVECTOR vLow = XMVectorFloor(XMVectorScale(vQ, 1.0f / float(1u << (2 * uPrec - 8))));
+        return XMVectorAdd(vHigh, vLow);
+    }
+
+    inline XMVECTOR QuantizeBatch(FXMVECTOR v, size_t uPrec) noexcept
+    {
+        const float fMax = float((1u << uPrec) - 1);
+        XMVECTOR vQ = XMVectorRound(XMVectorScale(v, fMax / 255.0f));
+        vQ = XMVectorClamp(vQ, XMVectorZero(), XMVectorReplicate(fMax));
+        return UnquantizeBatch(vQ, uPrec);
+    }
+
+    inline XMVECTOR QuantizeBatch(FXMVECTOR v, size_t uPrec, FXMVECTOR vPBit) noexcept
+    {
+        // Nearest value whose least significant bit is the p-bit
+        const float fMax = float((1u << uPrec) - 1);
+        XMVECTOR vQ = XMVectorSubtract(XMVectorScale(v, fMax / 255.0f), vPBit);
+        vQ = XMVectorRound(XMVectorScale(vQ, 0.5f));
+        vQ = XMVectorClamp(vQ, XMVectorZero(), XMVectorReplicate(float((1u << (uPrec - 1)) - 1)));
+        vQ = XMVectorMultiplyAdd(vQ, g_XMTwo, vPBit);
+        return UnquantizeBatch(vQ, uPrec);
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Quantizes a pair of endpoints to uPrec bits per channel. With p-bits the last bit is
+    // shared by the channels of an endpoint (or of both endpoints), and is picked per lane.
+    //-------------------------------------------------------------------------------------
+    void QuantizeEndPointsBatch(
+        _Inout_updates_all_(uChannels) XMVECTOR aEndPtA[],
+        _Inout_updates_all_(uChannels) XMVECTOR aEndPtB[],
+        size_t uChannels,
+        size_t uPrec,
+        bool bPBits,
+        bool bSharedPBit) noexcept
+    {
+        if (!bPBits)
+        {
+            for (size_t ch = 0; ch < uChannels; ++ch)
+            {
+                aEndPtA[ch] = QuantizeBatch(aEndPtA[ch], uPrec);
+                aEndPtB[ch] = QuantizeBatch(aEndPtB[ch], uPrec);
+            }
+            return;
+        }
+
+        XMVECTOR aQA[2][4];
+        XMVECTOR aQB[2][4];
+        XMVECTOR vErrA[2] = { XMVectorZero(), XMVectorZero() };
+        XMVECTOR vErrB[2] = { XMVectorZero(), XMVectorZero() };
+        for (size_t p = 0; p < 2; ++p)
+        {
+            const XMVECTOR vPBit = p ? g_XMOne : XMVectorZero();
+            for (size_t ch = 0; ch < uChannels; ++ch)
+            {
+                aQA[p][ch] = QuantizeBatch(aEndPtA[ch], uPrec, vPBit);
+                aQB[p][ch] = QuantizeBatch(aEndPtB[ch], uPrec, vPBit);
+                const XMVECTOR vDiffA = XMVectorSubtract(aQA[p][ch], aEndPtA[ch]);
+                const XMVECTOR vDiffB = XMVectorSubtract(aQB[p][ch], aEndPtB[ch]);
+                vErrA[p] = XMVectorMultiplyAdd(vDiffA, vDiffA, vErrA[p]);
+                vErrB[p] = XMVectorMultiplyAdd(vDiffB, vDiffB, vErrB[p]);
+            }
+        }
+
+        XMVECTOR vSelA, vSelB;
+        if (bSharedPBit)
+        {
+            vSelA = vSelB = XMVectorLess(XMVectorAdd(vErrA[1], vErrB[1]), XMVectorAdd(vErrA[0], vErrB[0]));
+        }
+        else
+        {
+            vSelA = XMVectorLess(vErrA[1], vErrA[0]);
+            vSelB = XMVectorLess(vErrB[1], vErrB[0]);
+        }
+
+        for (size_t ch = 0; ch < uChannels; ++ch)
+        {
+            aEndPtA[ch] = XMVectorSelect(aQA[0][ch], aQA[1][ch], vSelA);
+            aEndPtB[ch] = XMVectorSelect(aQB[0][ch], aQB[1][ch], vSelB);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Fits a line segment through the pixels of one subset of each block, one block per
+    // lane. aWeights are 1 for pixels in the subset and 0 otherwise.
+    //-------------------------------------------------------------------------------------
+    void FitSubsetBatch(
+        _In_reads_(uChannels) const XMVECTOR* const aChannels[],
+        size_t uChannels,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR aWeights[],
+        _Out_writes_all_(uChannels) XMVECTOR aEndPtA[],
+        _Out_writes_all_(uChannels) XMVECTOR aEndPtB[]) noexcept
+    {
+        assert(uChannels > 0 && uChannels <= 4);
+
+        XMVECTOR vCount = XMVectorZero();
+        XMVECTOR aMean[4] = { XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero() };
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            vCount = XMVectorAdd(vCount, aWeights[i]);
+            for (size_t ch = 0; ch < uChannels; ++ch)
+            {
+                aMean[ch] = XMVectorMultiplyAdd(aWeights[i], aChannels[ch][i], aMean[ch]);
+            }
+        }
+
+        const XMVECTOR vInvCount = XMVectorReciprocal(XMVectorMax(vCount, g_XMOne));
+        for (size_t ch = 0; ch < uChannels; ++ch)
+        {
+            aMean[ch] = XMVectorMultiply(aMean[ch], vInvCount);
+        }
+
+        XMVECTOR aCov[4][4] = {};
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            XMVECTOR aDiff[4];
+            for (size_t ch = 0; ch < uChannels; ++ch)
+            {
+                aDiff[ch] = XMVectorSubtract(aChannels[ch][i], aMean[ch]);
+            }
+
+            for (size_t j = 0; j < uChannels; ++j)
+            {
+                const XMVECTOR vWeighted = XMVectorMultiply(aWeights[i], aDiff[j]);
+                for (size_t k = j; k < uChannels; ++k)
+                {
+                    aCov[j][k] = XMVectorMultiplyAdd(vWeighted, aDiff[k], aCov[j][k]);
+                }
+            }
+        }
+
+        for (size_t j = 1; j < uChannels; ++j)
+        {
+            for (size_t k = 0; k < j; ++k)
+            {
+                aCov[j][k] = aCov[k][j];
+            }
+        }
+
+        // Principal axis by power iteration, starting from the row of the channel with the largest variance
+        XMVECTOR aAxis[4];
+        XMVECTOR vMaxVar = aCov[0][0];
+        for (size_t k = 0; k < uChannels; ++k)
+        {
+            aAxis[k] = aCov[0][k];
+        }
+
+        for (size_t j = 1; j < uChannels; ++j)
+        {
+            const XMVECTOR vSel = XMVectorGreater(aCov[j][j], vMaxVar);
+            vMaxVar = XMVectorSelect(vMaxVar, aCov[j][j], vSel);
+            for (size_t k = 0; k < uChannels; ++k)
+            {
+                aAxis[k] = XMVectorSelect(aAxis[k], aCov[j][k], vSel);
+            }
+        }
+
+        for (size_t iter = 0; iter < 4; ++iter)
+        {
+            XMVECTOR aNext[4];
+            XMVECTOR vLenSq = XMVectorZero();
+            for (size_t j = 0; j < uChannels; ++j)
+            {
+                aNext[j] = XMVectorZero();
+                for (size_t k = 0; k < uChannels; ++k)
+                {
+                    aNext[j] = XMVectorMultiplyAdd(aCov[j][k], aAxis[k], aNext[j]);
+                }
+                vLenSq = XMVectorMultiplyAdd(aNext[j], aNext[j], vLenSq);
+            }
+
+            const XMVECTOR vValid = XMVectorGreater(vLenSq, XMVectorZero());
+            const XMVECTOR vInvLen = XMVectorReciprocalSqrt(XMVectorMax(vLenSq, g_XMEpsilon));
+            for (size_t j = 0; j < uChannels; ++j)
+            {
+                aAxis[j] = XMVectorSelect(XMVectorZero(), XMVectorMultiply(aNext[j], vInvLen), vValid);
+            }
+        }
+
+        // Extent of the subset along the axis
+        XMVECTOR vMinT = g_XMFltMax;
+        XMVECTOR vMaxT = XMVectorNegate(g_XMFltMax);
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            XMVECTOR vT = XMVectorZero();
+            for (size_t ch = 0; ch < uChannels; ++ch)
+            {
+                vT = XMVectorMultiplyAdd(XMVectorSubtract(aChannels[ch][i], aMean[ch]), aAxis[ch], vT);
+            }
+
+            const XMVECTOR vInSubset = XMVectorGreater(aWeights[i], XMVectorZero());
+            vMinT = XMVectorSelect(vMinT, XMVectorMin(vMinT, vT), vInSubset);
+            vMaxT = XMVectorSelect(vMaxT, XMVectorMax(vMaxT, vT), vInSubset);
+        }
+
+        const XMVECTOR vMax = XMVectorReplicate(255.0f);
+        for (size_t ch = 0; ch < uChannels; ++ch)
+        {
+            aEndPtA[ch] = XMVectorClamp(XMVectorMultiplyAdd(vMinT, aAxis[ch], aMean[ch]), XMVectorZero(), vMax);
+            aEndPtB[ch] = XMVectorClamp(XMVectorMultiplyAdd(vMaxT, aAxis[ch], aMean[ch]), XMVectorZero(), vMax);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Squared error of the pixels in one subset of each block against the palette that the
+    // (already quantized) endpoints interpolate to
+    //-------------------------------------------------------------------------------------
+    XMVECTOR ErrorSubsetBatch(
+        _In_reads_(uChannels) const XMVECTOR* const aChannels[],
+        size_t uChannels,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR aWeights[],
+        _In_reads_(uChannels) const XMVECTOR aEndPtA[],
+        _In_reads_(uChannels) const XMVECTOR aEndPtB[],
+        size_t uIndexPrec) noexcept
+    {
+        assert(uChannels > 0 && uChannels <= 4);
+        assert(uIndexPrec >= 2 && uIndexPrec <= 4);
+
+        const int* aWeightTable = (uIndexPrec == 2) ? g_aWeights2 : ((uIndexPrec == 3) ? g_aWeights3 : g_aWeights4);
+        const size_t uNumIndices = size_t(1) << uIndexPrec;
+
+        XMVECTOR aPalette[BC7_MAX_INDICES][4];
+        for (size_t k = 0; k < uNumIndices; ++k)
+        {
+            const auto fWeight = static_cast<float>(aWeightTable[k]);
+            for (size_t ch = 0; ch < uChannels; ++ch)
+            {
+                // Same rounding as LDRColorA::Interpolate
+                XMVECTOR v = XMVectorScale(aEndPtA[ch], 64.0f - fWeight);
+                v = XMVectorMultiplyAdd(aEndPtB[ch], XMVectorReplicate(fWeight), v);
+                v = XMVectorAdd(v, XMVectorReplicate(32.0f));
+                aPalette[k][ch] = XMVectorFloor(XMVectorScale(v, 1.0f / 64.0f));
+            }
+        }
+
+        XMVECTOR vTotalErr = XMVectorZero();
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            XMVECTOR vBestErr = g_XMFltMax;
+            for (size_t k = 0; k < uNumIndices; ++k)
+            {
+                XMVECTOR vErr = XMVectorZero();
+                for (size_t ch = 0; ch < uChannels; ++ch)
+                {
+                    const XMVECTOR vDiff = XMVectorSubtract(aChannels[ch][i], aPalette[k][ch]);
+                    vErr = XMVectorMultiplyAdd(vDiff, vDiff, vErr);
+                }
+                vBestErr = XMVectorMin(vBestErr, vErr);
+            }
+            vTotalErr = XMVectorMultiplyAdd(aWeights[i], vBestErr, vTotalErr);
+        }
+
+        return vTotalErr;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Error left after fitting a line to a set of RGB pixels, given the channel sums, the
+    // sums of the channel products (rr, gg, bb, rg, rb, gb) and the pixel count
+    //-------------------------------------------------------------------------------------
+    XMVECTOR LineResidualBatch(
+        _In_reads_(3) const XMVECTOR aSum[],
+        _In_reads_(6) const XMVECTOR aSumSq[],
+        size_t uCount) noexcept
+    {
+        assert(uCount > 0);
+        const float fInvCount = 1.0f / float(uCount);
+
+        XMVECTOR aCov[3][3];
+        aCov[0][0] = XMVectorSubtract(aSumSq[0], XMVectorScale(XMVectorMultiply(aSum[0], aSum[0]), fInvCount));
+        aCov[1][1] = XMVectorSubtract(aSumSq[1], XMVectorScale(XMVectorMultiply(aSum[1], aSum[1]), fInvCount));
+        aCov[2][2] = XMVectorSubtract(aSumSq[2], XMVectorScale(XMVectorMultiply(aSum[2], aSum[2]), fInvCount));
+        aCov[0][1] = aCov[1][0] = XMVectorSubtract(aSumSq[3], XMVectorScale(XMVectorMultiply(aSum[0], aSum[1]), fInvCount));
+        aCov[0][2] = aCov[2][0] = XMVectorSubtract(aSumSq[4], XMVectorScale(XMVectorMultiply(aSum[0], aSum[2]), fInvCount));
+        aCov[1][2] = aCov[2][1] = XMVectorSubtract(aSumSq[5], XMVectorScale(XMVectorMultiply(aSum[1], aSum[2]), fInvCount));
+
+        const XMVECTOR vTrace = XMVectorAdd(XMVectorAdd(aCov[0][0], aCov[1][1]), aCov[2][2]);
+
+        XMVECTOR aAxis[3] = { aCov[0][0], aCov[0][1], aCov[0][2] };
+        XMVECTOR vMaxVar = aCov[0][0];
+        for (size_t j = 1; j < 3; ++j)
+        {
+            const XMVECTOR vSel = XMVectorGreater(aCov[j][j], vMaxVar);
+            vMaxVar = XMVectorSelect(vMaxVar, aCov[j][j], vSel);
+            for (size_t k = 0; k < 3; ++k)
+            {
+                aAxis[k] = XMVectorSelect(aAxis[k], aCov[j][k], vSel);
+            }
+        }
+
+        XMVECTOR aNext[3];
+        for (size_t iter = 0; iter < 3; ++iter)
+        {
+            for (size_t j = 0; j < 3; ++j)
+            {
+                aNext[j] = XMVectorMultiply(aCov[j][0], aAxis[0]);
+                aNext[j] = XMVectorMultiplyAdd(aCov[j][1], aAxis[1], aNext[j]);
+                aNext[j] = XMVectorMultiplyAdd(aCov[j][2], aAxis[2], aNext[j]);
+            }
+
+            XMVECTOR vLenSq = XMVectorMultiply(aNext[0], aNext[0]);
+            vLenSq = XMVectorMultiplyAdd(aNext[1], aNext[1], vLenSq);
+            vLenSq = XMVectorMultiplyAdd(aNext[2], aNext[2], vLenSq);
+            const XMVECTOR vInvLen = XMVectorReciprocalSqrt(XMVectorMax(vLenSq, g_XMEpsilon));
+            for (size_t j = 0; j < 3; ++j)
+            {
+                aAxis[j] = XMVectorMultiply(aNext[j], vInvLen);
+            }
+        }
+
+        // Variance along the axis (Rayleigh quotient of the unit axis)
+        XMVECTOR vAxisVar = XMVectorZero();
+        for (size_t j = 0; j < 3; ++j)
+        {
+            XMVECTOR vProj = XMVectorMultiply(aCov[j][0], aAxis[0]);
+            vProj = XMVectorMultiplyAdd(aCov[j][1], aAxis[1], vProj);
+            vProj = XMVectorMultiplyAdd(aCov[j][2], aAxis[2], vProj);
+            vAxisVar = XMVectorMultiplyAdd(aAxis[j], vProj, vAxisVar);
+        }
+
+        return XMVectorMax(XMVectorSubtract(vTrace, vAxisVar), XMVectorZero());
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Ranks the 2 subset shapes of each block by how well a line fits each of the subsets,
+    // using the partition bitmasks to accumulate the subset moments
+    //-------------------------------------------------------------------------------------
+    void RankShapesBatch(
+        _In_reads_(3) const XMVECTOR* const aChannels[],
+        _Out_writes_(NUM_BLOCKS_PER_BATCH) uint8_t auShapes[][BC7_BATCH_SHAPES]) noexcept
+    {
+        XMVECTOR aSumSq[6][NUM_PIXELS_PER_BLOCK];
+        XMVECTOR aTotal[3] = { XMVectorZero(), XMVectorZero(), XMVectorZero() };
+        XMVECTOR aTotalSq[6] = { XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero() };
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            aSumSq[0][i] = XMVectorMultiply(aChannels[0][i], aChannels[0][i]);
+            aSumSq[1][i] = XMVectorMultiply(aChannels[1][i], aChannels[1][i]);
+            aSumSq[2][i] = XMVectorMultiply(aChannels[2][i], aChannels[2][i]);
+            aSumSq[3][i] = XMVectorMultiply(aChannels[0][i], aChannels[1][i]);
+            aSumSq[4][i] = XMVectorMultiply(aChannels[0][i], aChannels[2][i]);
+            aSumSq[5][i] = XMVectorMultiply(aChannels[1][i], aChannels[2][i]);
+
+            for (size_t ch = 0; ch < 3; ++ch)
+            {
+                aTotal[ch] = XMVectorAdd(aTotal[ch], aChannels[ch][i]);
+            }
+            for (size_t k = 0; k < 6; ++k)
+            {
+                aTotalSq[k] = XMVectorAdd(aTotalSq[k], aSumSq[k][i]);
+            }
+        }
+
+        XMFLOAT4A afErr[BC7_MAX_SHAPES];
+        for (size_t uShape = 0; uShape < BC7_MAX_SHAPES; ++uShape)
+        {
+            const uint32_t uMask = g_aPartitionMask[1][uShape][1];
+
+            XMVECTOR aSum[3] = { XMVectorZero(), XMVectorZero(), XMVectorZero() };
+            XMVECTOR aSubSq[6] = { XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero() };
+            size_t uCount = 0;
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+            {
+                if (uMask & (1u << i))
+                {
+                    ++uCount;
+                    for (size_t ch = 0; ch < 3; ++ch)
+                    {
+                        aSum[ch] = XMVectorAdd(aSum[ch], aChannels[ch][i]);
+                    }
+                    for (size_t k = 0; k < 6; ++k)
+                    {
+                        aSubSq[k] = XMVectorAdd(aSubSq[k], aSumSq[k][i]);
+                    }
+                }
+            }
+
+            XMVECTOR vErr = LineResidualBatch(aSum, aSubSq, uCount);
+
+            for (size_t ch = 0; ch < 3; ++ch)
+            {
+                aSum[ch] = XMVectorSubtract(aTotal[ch], aSum[ch]);
+            }
+            for (size_t k = 0; k < 6; ++k)
+            {
+                aSubSq[k] = XMVectorSubtract(aTotalSq[k], aSubSq[k]);
+            }
+
+            vErr = XMVectorAdd(vErr, LineResidualBatch(aSum, aSubSq, NUM_PIXELS_PER_BLOCK - uCount));
+            XMStoreFloat4A(&afErr[uShape], vErr);
+        }
+
+        for (size_t j = 0; j < NUM_BLOCKS_PER_BATCH; ++j)
+        {
+            float afBest[BC7_BATCH_SHAPES];
+            for (size_t k = 0; k < BC7_BATCH_SHAPES; ++k)
+            {
+                afBest[k] = FLT_MAX;
+                auShapes[j][k] = 0;
+            }
+
+            for (size_t uShape = 0; uShape < BC7_MAX_SHAPES; ++uShape)
+            {
+                float fErr = (&afErr[uShape].x)[j];
+                auto uCur = static_cast<uint8_t>(uShape);
+                for (size_t k = 0; k < BC7_BATCH_SHAPES; ++k)
+                {
+                    if (fErr < afBest[k])
+                    {
+                        std::swap(fErr, afBest[k]);
+                        std::swap(uCur, auShapes[j][k]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Records the lanes where vErr improves on the best candidate found so far
+    void UpdateCandidatesBatch(
+        FXMVECTOR vErr,
+        uint8_t uMode,
+        _In_reads_(NUM_BLOCKS_PER_BATCH) const uint8_t auShape[],
+        uint8_t uRotation,
+        size_t uPartitions,
+        _In_reads_(4) const XMVECTOR* aEndPtA,
+        _In_reads_(4) const XMVECTOR* aEndPtB,
+        _Inout_updates_all_(NUM_BLOCKS_PER_BATCH) BC7BatchCandidate aBest[][BC7_BATCH_REFINE]) noexcept
+    {
+        XMFLOAT4A fErr;
+        XMStoreFloat4A(&fErr, vErr);
+
+        XMFLOAT4A fA[BC7_MAX_REGIONS * 4];
+        XMFLOAT4A fB[BC7_MAX_REGIONS * 4];
+        for (size_t k = 0; k < (uPartitions + 1) * 4; ++k)
+        {
+            XMStoreFloat4A(&fA[k], aEndPtA[k]);
+            XMStoreFloat4A(&fB[k], aEndPtB[k]);
+        }
+
+        for (size_t j = 0; j < NUM_BLOCKS_PER_BATCH; ++j)
+        {
+            BC7BatchCandidate candidate = {};
+            candidate.fErr = (&fErr.x)[j];
+            candidate.uMode = uMode;
+            candidate.uShape = auShape[j];
+            candidate.uRotation = uRotation;
+            for (size_t p = 0; p <= uPartitions; ++p)
+            {
+                for (size_t ch = 0; ch < 4; ++ch)
+                {
+                    candidate.aEndPts[p].A[ch] = static_cast<uint8_t>((&fA[p * 4 + ch].x)[j] + 0.5f);
+                    candidate.aEndPts[p].B[ch] = static_cast<uint8_t>((&fB[p * 4 + ch].x)[j] + 0.5f);
+                }
+            }
+
+            // Keep the list sorted by estimated error
+            for (size_t k = 0; k < BC7_BATCH_REFINE; ++k)
+            {
+                if (candidate.fErr < aBest[j][k].fErr)
+                    std::swap(candidate, aBest[j][k]);
+            }
+        }
+    }
+}
+
+_Use_decl_annotations_
+void D3DX_BC7::EncodeBatch(uint32_t flags, float fErrorTarget, const HDRColorA* const pIn, D3DX_BC7* pOut) noexcept
+{
+    assert(pIn && pOut);
+    assert(fErrorTarget >= 0.0f);
+    static_assert(NUM_BLOCKS_PER_BATCH == 4, "Batch size must match the XMVECTOR lane count");
+    UNREFERENCED_PARAMETER(flags);
+
+    // Transpose to one XMVECTOR per channel and pixel, one block per lane, with the same 8-bit rounding as Encode
+    XMVECTOR aPixels[BC7_NUM_CHANNELS][NUM_PIXELS_PER_BLOCK];
+    const XMVECTOR vScale = XMVectorReplicate(255.0f);
+    const XMVECTOR vBias = XMVectorReplicate(0.01f);
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        XMMATRIX m(
+            XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&pIn[i])),
+            XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&pIn[i + NUM_PIXELS_PER_BLOCK])),
+            XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&pIn[i + NUM_PIXELS_PER_BLOCK * 2])),
+            XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&pIn[i + NUM_PIXELS_PER_BLOCK * 3])));
+        m = XMMatrixTranspose(m);
+
+        for (size_t ch = 0; ch < BC7_NUM_CHANNELS; ++ch)
+        {
+            aPixels[ch][i] = XMVectorTruncate(XMVectorClamp(XMVectorMultiplyAdd(m.r[ch], vScale, vBias), XMVectorZero(), vScale));
+        }
+    }
+
+    XMVECTOR aOnes[NUM_PIXELS_PER_BLOCK];
+    XMVECTOR vAlphaErr = XMVectorZero();
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        aOnes[i] = g_XMOne;
+        const XMVECTOR vDiff = XMVectorSubtract(vScale, aPixels[3][i]);
+        vAlphaErr = XMVectorMultiplyAdd(vDiff, vDiff, vAlphaErr);
+    }
+
+    BC7BatchCandidate aBest[NUM_BLOCKS_PER_BATCH][BC7_BATCH_REFINE] = {};
+    for (size_t j = 0; j < NUM_BLOCKS_PER_BATCH; ++j)
+    {
+        for (size_t k = 0; k < BC7_BATCH_REFINE; ++k)
+        {
+            aBest[j][k].fErr = FLT_MAX;
+        }
+    }
+
+    static const uint8_t s_auNoShape[NUM_BLOCKS_PER_BATCH] = {};
+    XMVECTOR aEndPtA[BC7_MAX_REGIONS * 4];
+    XMVECTOR aEndPtB[BC7_MAX_REGIONS * 4];
+
+    // Mode 6: one subset, RGBA together
+    {
+        const ModeInfo& info = ms_aInfo[6];
+        const XMVECTOR* const aChannels[4] = { aPixels[0], aPixels[1], aPixels[2], aPixels[3] };
+        FitSubsetBatch(aChannels, 4, aOnes, aEndPtA, aEndPtB);
+
+        XMVECTOR aQA[4] = { aEndPtA[0], aEndPtA[1], aEndPtA[2], aEndPtA[3] };
+        XMVECTOR aQB[4] = { aEndPtB[0], aEndPtB[1], aEndPtB[2], aEndPtB[3] };
+        QuantizeEndPointsBatch(aQA, aQB, 4, info.RGBAPrecWithP.r, true, false);
+
+        const XMVECTOR vErr = ErrorSubsetBatch(aChannels, 4, aOnes, aQA, aQB, info.uIndexPrec);
+        UpdateCandidatesBatch(vErr, 6, s_auNoShape, 0, 0, aEndPtA, aEndPtB, aBest);
+    }
+
+    // Mode 5: one subset, RGB and a separate scalar which is alpha or, rotated, one of the color channels
+    {
+        const ModeInfo& info = ms_aInfo[5];
+        for (uint8_t uRotation = 0; uRotation < 4; ++uRotation)
+        {
+            const XMVECTOR* aChannels[4] = { aPixels[0], aPixels[1], aPixels[2], aPixels[3] };
+            if (uRotation)
+                std::swap(aChannels[uRotation - 1], aChannels[3]);
+
+            FitSubsetBatch(aChannels, 3, aOnes, aEndPtA, aEndPtB);
+            FitSubsetBatch(&aChannels[3], 1, aOnes, &aEndPtA[3], &aEndPtB[3]);
+
+            XMVECTOR aQA[4] = { aEndPtA[0], aEndPtA[1], aEndPtA[2], aEndPtA[3] };
+            XMVECTOR aQB[4] = { aEndPtB[0], aEndPtB[1], aEndPtB[2], aEndPtB[3] };
+            QuantizeEndPointsBatch(aQA, aQB, 3, info.RGBAPrecWithP.r, false, false);
+            QuantizeEndPointsBatch(&aQA[3], &aQB[3], 1, info.RGBAPrecWithP.a, false, false);
+
+            XMVECTOR vErr = ErrorSubsetBatch(aChannels, 3, aOnes, aQA, aQB, info.uIndexPrec);
+            vErr = XMVectorAdd(vErr, ErrorSubsetBatch(&aChannels[3], 1, aOnes, &aQA[3], &aQB[3], info.uIndexPrec2));
+            UpdateCandidatesBatch(vErr, 5, s_auNoShape, uRotation, 0, aEndPtA, aEndPtB, aBest);
+        }
+    }
+
+    // Modes 1 and 3: two subsets, RGB only. Their alpha decodes as 255, which bounds the error from below.
+    XMFLOAT4A fAlphaErr;
+    XMStoreFloat4A(&fAlphaErr, vAlphaErr);
+    bool bTryPartitions = false;
+    for (size_t j = 0; j < NUM_BLOCKS_PER_BATCH; ++j)
+    {
+        bTryPartitions |= ((&fAlphaErr.x)[j] < aBest[j][BC7_BATCH_REFINE - 1].fErr);
+    }
+
+    if (bTryPartitions)
+    {
+        const XMVECTOR* const aChannels[3] = { aPixels[0], aPixels[1], aPixels[2] };
+
+        uint8_t auShapes[NUM_BLOCKS_PER_BATCH][BC7_BATCH_SHAPES];
+        RankShapesBatch(aChannels, auShapes);
+
+        for (size_t k = 0; k < BC7_BATCH_SHAPES; ++k)
+        {
+            uint8_t auShape[NUM_BLOCKS_PER_BATCH];
+            XMVECTOR aWeights[2][NUM_PIXELS_PER_BLOCK];
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+            {
+                XMFLOAT4A fSubset;
+                for (size_t j = 0; j < NUM_BLOCKS_PER_BATCH; ++j)
+                {
+                    auShape[j] = auShapes[j][k];
+                    (&fSubset.x)[j] = (g_aPartitionMask[1][auShape[j]][1] & (1u << i)) ? 1.0f : 0.0f;
+                }
+                aWeights[1][i] = XMLoadFloat4A(&fSubset);
+                aWeights[0][i] = XMVectorSubtract(g_XMOne, aWeights[1][i]);
+            }
+
+            for (size_t p = 0; p < 2; ++p)
+            {
+                FitSubsetBatch(aChannels, 3, aWeights[p], &aEndPtA[p * 4], &aEndPtB[p * 4]);
+                aEndPtA[p * 4 + 3] = aEndPtB[p * 4 + 3] = vScale;
+            }
+
+            static const uint8_t s_auModes[] = { 1, 3 };
+            for (const uint8_t uMode : s_auModes)
+            {
+                const ModeInfo& info = ms_aInfo[uMode];
+                XMVECTOR vErr = vAlphaErr;
+                for (size_t p = 0; p < 2; ++p)
+                {
+                    XMVECTOR aQA[3] = { aEndPtA[p * 4], aEndPtA[p * 4 + 1], aEndPtA[p * 4 + 2] };
+                    XMVECTOR aQB[3] = { aEndPtB[p * 4], aEndPtB[p * 4 + 1], aEndPtB[p * 4 + 2] };
+                    QuantizeEndPointsBatch(aQA, aQB, 3, info.RGBAPrecWithP.r, true, info.uPBits == 2);
+                    vErr = XMVectorAdd(vErr, ErrorSubsetBatch(aChannels, 3, aWeights[p], aQA, aQB, info.uIndexPrec));
+                }
+                UpdateCandidatesBatch(vErr, uMode, auShape, 0, 1, aEndPtA, aEndPtB, aBest);
+            }
+        }
+    }
+
+    // Refine the best candidates of each block with the same endpoint optimization Encode uses
+    for (size_t j = 0; j < NUM_BLOCKS_PER_BATCH; ++j)
+    {
+        const HDRColorA* pBlock = &pIn[j * NUM_PIXELS_PER_BLOCK];
+        D3DX_BC7 block;
+        float fMSEBest = FLT_MAX;
+
+        EncodeParams EP(pBlock);
+
+        // An all-zero block is reserved, so it decodes as an error block if nothing below is kept
+        memset(&pOut[j], 0, sizeof(D3DX_BC7));
+
+        // Candidates are refined best estimate first, until one is within the error target
+        for (size_t k = 0; k < BC7_BATCH_REFINE && fMSEBest > fErrorTarget; ++k)
+        {
+            const BC7BatchCandidate& candidate = aBest[j][k];
+            if (candidate.fErr == FLT_MAX)
+                break;
+
+            if (candidate.uRotation)
+            {
+                for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+                    std::swap(EP.aLDRPixels[i][candidate.uRotation - 1u], EP.aLDRPixels[i].a);
+            }
+
+            EP.uMode = candidate.uMode;
+            for (size_t p = 0; p <= ms_aInfo[candidate.uMode].uPartitions; ++p)
+            {
+                EP.aEndPts[candidate.uShape][p] = candidate.aEndPts[p];
+            }
+
+            const float fMSE = block.Refine(&EP, candidate.uShape, candidate.uRotation, 0);
+            if (fMSE < fMSEBest)
+            {
+                pOut[j] = block;
+                fMSEBest = fMSE;
+            }
+
+            if (candidate.uRotation)
+            {
+                for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+                    std::swap(EP.aLDRPixels[i][candidate.uRotation - 1u], EP.aLDRPixels[i].a);
+            }
+        }
+
+        if (fMSEBest == FLT_MAX)
+        {
+            // No candidate had a usable error estimate (such as from NaN input), so fall back to the mode 6 search of Encode
+            pOut[j].Encode(&EP, BC_FLAGS_FORCE_BC7_MODE6, 0.0f);
+        }
+    }
+}
+
+
+//=====================================================================================
+// Entry points
+//=====================================================================================
+
+//-------------------------------------------------------------------------------------
+// BC6H Compression
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC6HU(XMVECTOR *pColor, const uint8_t *pBC) noexcept
+{
+    assert(pColor && pBC);
+    static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
+    reinterpret_cast<const D3DX_BC6H*>(pBC)->Decode(false, reinterpret_cast<HDRColorA*>(pColor));
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC6HUToHalf(XMHALF4 *pColor, const uint8_t *pBC, size_t count) noexcept
+{
+    assert(pColor && pBC);
+    static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
+
+    auto pBlocks = reinterpret_cast<const D3DX_BC6H*>(pBC);
+    for (size_t j = 0; j < count; ++j)
+    {
+        pBlocks[j].Decode(false, &pColor[j * NUM_PIXELS_PER_BLOCK]);
+    }
 }
 
 _Use_decl_annotations_
@@ -3620,22 +4824,61 @@ void DirectX::D3DXDecodeBC6HS(XMVECTOR *pColor, const uint8_t *pBC) noexcept
     reinterpret_cast<const D3DX_BC6H*>(pBC)->Decode(true, reinterpret_cast<HDRColorA*>(pColor));
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC6HSToHalf(XMHALF4 *pColor, const uint8_t *pBC, size_t count) noexcept
+{
+    assert(pColor && pBC);
+    static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
+
+    auto pBlocks = reinterpret_cast<const D3DX_BC6H*>(pBC);
+    for (size_t j = 0; j < count; ++j)
+    {
+        pBlocks[j].Decode(true, &pColor[j * NUM_PIXELS_PER_BLOCK]);
+    }
+}
+
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC6HU(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
+    D3DXEncodeBC6HU(pBC, pColor, 0.f, flags);
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC6HU(uint8_t *pBC, const XMVECTOR *pColor, float errorTarget, uint32_t flags) noexcept
+{
     assert(pBC && pColor);
     static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
-    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(false, reinterpret_cast<const HDRColorA*>(pColor));
+    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(false, flags, errorTarget * float(NUM_PIXELS_PER_BLOCK), reinterpret_cast<const HDRColorA*>(pColor));
 }
 
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC6HS(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
+    D3DXEncodeBC6HS(pBC, pColor, 0.f, flags);
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC6HS(uint8_t *pBC, const XMVECTOR *pColor, float errorTarget, uint32_t flags) noexcept
+{
     assert(pBC && pColor);
     static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
-    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(true, reinterpret_cast<const HDRColorA*>(pColor));
+    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(true, flags, errorTarget * float(NUM_PIXELS_PER_BLOCK), reinterpret_cast<const HDRColorA*>(pColor));
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC6HUFromHalf(uint8_t *pBC, const XMHALF4 *pColor, float errorTarget, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
+    static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
+    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(false, flags, errorTarget * float(NUM_PIXELS_PER_BLOCK), pColor);
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC6HSFromHalf(uint8_t *pBC, const XMHALF4 *pColor, float errorTarget, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
+    static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
+    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(true, flags, errorTarget * float(NUM_PIXELS_PER_BLOCK), pColor);
 }
 
 
@@ -3650,10 +4893,47 @@ void DirectX::D3DXDecodeBC7(XMVECTOR *pColor, const uint8_t *pBC) noexcept
     reinterpret_cast<const D3DX_BC7*>(pBC)->Decode(reinterpret_cast<HDRColorA*>(pColor));
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC7ToRGBA8(XMUBYTEN4 *pColor, const uint8_t *pBC, size_t count) noexcept
+{
+    assert(pColor && pBC);
+    static_assert(sizeof(D3DX_BC7) == 16, "D3DX_BC7 should be 16 bytes");
+    static_assert(sizeof(LDRColorA) == sizeof(XMUBYTEN4), "LDRColorA should be 4 bytes");
+
+    // The block's 8-bit colors are the pixels, so there is nothing left to round
+    auto pBlocks = reinterpret_cast<const D3DX_BC7*>(pBC);
+    for (size_t j = 0; j < count; ++j)
+    {
+        pBlocks[j].Decode(reinterpret_cast<LDRColorA*>(&pColor[j * NUM_PIXELS_PER_BLOCK]));
+    }
+}
+
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC7(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
+{
+    D3DXEncodeBC7(pBC, pColor, 0.f, flags);
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC7(uint8_t *pBC, const XMVECTOR *pColor, float errorTarget, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
+    static_assert(sizeof(D3DX_BC7) == 16, "D3DX_BC7 should be 16 bytes");
+    reinterpret_cast<D3DX_BC7*>(pBC)->Encode(flags, errorTarget * float(NUM_PIXELS_PER_BLOCK), reinterpret_cast<const HDRColorA*>(pColor));
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC7FromRGBA8(uint8_t *pBC, const XMUBYTEN4 *pColor, float errorTarget, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
+    static_assert(sizeof(D3DX_BC7) == 16, "D3DX_BC7 should be 16 bytes");
+    reinterpret_cast<D3DX_BC7*>(pBC)->Encode(flags, errorTarget * float(NUM_PIXELS_PER_BLOCK), pColor);
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC7Batch(uint8_t *pBC, const XMVECTOR *pColor, float errorTarget, uint32_t flags) noexcept
 {
     assert(pBC && pColor);
     static_assert(sizeof(D3DX_BC7) == 16, "D3DX_BC7 should be 16 bytes");
-    reinterpret_cast<D3DX_BC7*>(pBC)->Encode(flags, reinterpret_cast<const HDRColorA*>(pColor));
+    D3DX_BC7::EncodeBatch(flags, errorTarget * float(NUM_PIXELS_PER_BLOCK), reinterpret_cast<const HDRColorA*>(pColor), reinterpret_cast<D3DX_BC7*>(pBC));
 }
@@ -786,6 +786,9 @@ namespace DirectX
 
         TEX_FILTER_FORCE_WIC = 0x20000000,
         // Forces use of the WIC path even when logic would have picked a non-WIC path when both are an option
+
+        TEX_FILTER_PARALLEL = 0x40000000,
+        // Convert is free to use multithreading to improve performance (by default it does not use multithreading); see SetTaskScheduler
     };
 
     constexpr uint32_t TEX_FILTER_DITHER_MASK = 0xF0000;
@@ -809,7 +812,9 @@ namespace DirectX
     {
         TEX_FILTER_FLAGS filter;
         float            threshold;
+        size_t           maxThreads;
     };
+        // maxThreads caps the threads used by TEX_FILTER_PARALLEL, counting the calling thread (0 means no limit)
 
     DIRECTX_TEX_API HRESULT __cdecl Convert(
         _In_ const Image& srcImage, _In_ DXGI_FORMAT format, _In_ TEX_FILTER_FLAGS filter, _In_ float threshold,
@@ -902,25 +907,83 @@ namespace DirectX
         TEX_COMPRESS_BC7_QUICK = 0x100000,
         // Minimal modes (usually mode 6) for BC7 compression
 
+        TEX_COMPRESS_EFFORT_FAST = 0x200000,
+        // Range-fit endpoints for BC1-5 compression; skips the iterative endpoint refinement. BC7 skips modes and rotations unlikely to win
+
+        TEX_COMPRESS_EFFORT_BEST = 0x400000,
+        // Local endpoint refinement for BC1-5 compression: BC1-3 color endpoints step by one while the error drops and
+        // alpha/BC4-5 endpoints try every pair within 4 steps, with exact nearest-index selection; slowest, but lowest error
+
+        TEX_COMPRESS_BC6H_QUICK = 0x800000,
+        // Minimal modes for BC6H compression; one region modes, plus the best partitions of two region modes for blocks that need them
+
         TEX_COMPRESS_SRGB_IN = 0x1000000,
         TEX_COMPRESS_SRGB_OUT = 0x2000000,
         TEX_COMPRESS_SRGB = (TEX_COMPRESS_SRGB_IN | TEX_COMPRESS_SRGB_OUT),
         // if the input format type is IsSRGB(), then SRGB_IN is on by default
         // if the output format type is IsSRGB(), then SRGB_OUT is on by default
 
+        TEX_COMPRESS_DEDUPLICATE = 0x4000000,
+        // CPU compression encodes each distinct block once; repeats anywhere in the image set reuse its encoding.
+        // The cache holds up to 65536 distinct blocks (about 20 MB) and drops older ones as it fills up
+
+        TEX_COMPRESS_BC7_BATCH = 0x8000000,
+        // Fastest CPU BC7 compression: searches only modes 1, 3, 5 and 6, several blocks at a time, at some loss of quality
+
         TEX_COMPRESS_PARALLEL = 0x10000000,
-        // Compress is free to use multithreading to improve performance (by default it does not use multithreading)
+        // Compress is free to use multithreading to improve performance (by default it does not use multithreading); see SetTaskScheduler
     };
 
     constexpr float TEX_ALPHA_WEIGHT_DEFAULT = 1.0f;
         // Default value for alpha weight used for GPU BC7 compression
 
+    struct CompressBlockInfo
+    {
+        float       mse;    // Mean squared error per pixel and channel of the decoded block against its source
+        uint32_t    mode;   // Block mode for BC6H (0-13) and BC7 (0-7), or 0 for the other formats
+    };
+
+    struct CompressStats
+    {
+        size_t      blocks;             // Blocks written, including the solid and cached ones
+        size_t      solidBlocks;        // Blocks of a single color, encoded from tables
+        size_t      cachedBlocks;       // Blocks copied from an identical block by TEX_COMPRESS_DEDUPLICATE
+        size_t      withinTargetBlocks; // Encoded BC6H and BC7 blocks whose decoded error is at or below errorTarget (if > 0)
+        size_t      bc1ThreeColor;      // BC1 blocks using the 3-color (and transparent) palette
+        size_t      bc1FourColor;       // BC1 blocks using the 4-color palette
+        size_t      modes[14];          // BC6H (0-13) and BC7 (0-7) blocks per mode
+        size_t      partitions2[64];    // BC6H and BC7 two-subset blocks per partition shape
+        size_t      partitions3[64];    // BC7 three-subset blocks per partition shape
+        size_t      rotations[4];       // BC7 mode 4 and 5 blocks per channel rotation
+        size_t      threads;            // Threads that encoded blocks
+        double      seconds;            // Wall time of the call
+        double      busySeconds;        // Time spent encoding block rows, summed over threads
+        double      maxThreadSeconds;   // Time the busiest thread spent encoding block rows
+        double*     imageSeconds;       // Optional, set by the caller: receives busySeconds per image
+    };
+
     struct CompressOptions
     {
-        TEX_COMPRESS_FLAGS flags;
-        float              threshold;
-        float              alphaWeight;
+        TEX_COMPRESS_FLAGS  flags;
+        float               threshold;
+        float               alphaWeight;
+        float               errorTarget;
+        size_t              maxThreads;
+        float               rdoLambda;
+        CompressBlockInfo*  blockInfo;
+        CompressStats*      stats;
     };
+        // maxThreads caps the threads used by TEX_COMPRESS_PARALLEL, counting the calling thread (0 means no limit)
+        // rdoLambda > 0 lets BC1, BC3 and BC7 blocks reuse bits of the preceding blocks in their row when that saves
+        // more estimated LZ-compressed bits than lambda times the added squared error costs (0 disables)
+        // blockInfo, if not null, receives the error and mode of every 4x4 block the CPU encoder writes: one entry per
+        // block in row order for each image in turn, so ((width + 3) / 4) * ((height + 3) / 4) entries per image. Errors
+        // are over the channels the format stores, on the values the encoder sees. CompressRegion fills in only its blocks
+        // stats, if not null, receives what the CPU encoder did. Every field but imageSeconds is overwritten; imageSeconds,
+        // if not null, must hold one entry per image
+        // errorTarget is only used by the CPU BC6H and BC7 encoders, which stop searching modes and shapes once the
+        // mean squared error per pixel of a block is at or below it (0 searches all of them). The error is summed over
+        // RGBA in 8-bit steps for BC7, and over RGB in half-float steps for BC6H
 
     DIRECTX_TEX_API HRESULT __cdecl Compress(
         _In_ const Image& srcImage, _In_ DXGI_FORMAT format, _In_ TEX_COMPRESS_FLAGS compress, _In_ float threshold,
@@ -938,6 +1001,7 @@ namespace DirectX
         _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
         _In_ DXGI_FORMAT format, _In_ const CompressOptions& options, _Out_ ScratchImage& cImages,
         _In_ std::function<bool __cdecl(size_t, size_t)> statusCallBack = nullptr);
+        // statusCallBack receives progress in rows of 4x4 blocks, summed over all the images
 
 #if defined(__d3d11_h__) || defined(__d3d11_x_h__)
     DIRECTX_TEX_API HRESULT __cdecl Compress(
@@ -958,11 +1022,34 @@ namespace DirectX
         _In_ std::function<bool __cdecl(size_t, size_t)> statusCallBack = nullptr);
 #endif
 
-    DIRECTX_TEX_API HRESULT __cdecl Decompress(_In_ const Image& cImage, _In_ DXGI_FORMAT format, _Out_ ScratchImage& image) noexcept;
+    enum TEX_DECOMPRESS_FLAGS : uint32_t
+    {
+        TEX_DECOMPRESS_DEFAULT = 0,
+
+        TEX_DECOMPRESS_PARALLEL = 0x10000000,
+        // Decompress is free to use multithreading for large images (by default it does not use multithreading); see SetTaskScheduler
+    };
+
+    struct DecompressOptions
+    {
+        TEX_DECOMPRESS_FLAGS    flags;
+        size_t                  maxThreads;
+    };
+        // maxThreads caps the threads used by TEX_DECOMPRESS_PARALLEL, counting the calling thread (0 means no limit)
+
+    DIRECTX_TEX_API HRESULT __cdecl Decompress(
+        _In_ const Image& cImage, _In_ DXGI_FORMAT format, _Out_ ScratchImage& image) noexcept;
     DIRECTX_TEX_API HRESULT __cdecl Decompress(
         _In_reads_(nimages) const Image* cImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
         _In_ DXGI_FORMAT format, _Out_ ScratchImage& images) noexcept;
 
+    DIRECTX_TEX_API HRESULT __cdecl DecompressEx(
+        _In_ const Image& cImage, _In_ DXGI_FORMAT format, _In_ const DecompressOptions& options,
+        _Out_ ScratchImage& image) noexcept;
+    DIRECTX_TEX_API HRESULT __cdecl DecompressEx(
+        _In_reads_(nimages) const Image* cImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
+        _In_ DXGI_FORMAT format, _In_ const DecompressOptions& options, _Out_ ScratchImage& images) noexcept;
+
     //---------------------------------------------------------------------------------
     // Normal map operations
 
@@ -1015,6 +1102,18 @@ namespace DirectX
         _In_ const Image& srcImage, _In_ const Rect& srcRect, _In_ const Image& dstImage,
         _In_ TEX_FILTER_FLAGS filter, _In_ size_t xOffset, _In_ size_t yOffset) noexcept;
 
+    DIRECTX_TEX_API HRESULT __cdecl CompressRegion(
+        _In_ const Image& srcImage, _In_ const Rect& rect, _In_ const CompressOptions& options,
+        _In_ const Image& cImage) noexcept;
+    DIRECTX_TEX_API HRESULT __cdecl CompressRegion(
+        _In_ const Image& srcImage, _In_reads_(nrects) const Rect* rects, _In_ size_t nrects,
+        _In_ const CompressOptions& options, _In_ const Image& cImage) noexcept;
+        // Re-encodes only the blocks of an existing compressed image (the same size as srcImage) that cover the
+        // rectangle(s). Rectangles are widened to whole blocks, and the blocks of overlapping dirty rectangles are
+        // encoded once. Blocks outside them are left untouched. With rdoLambda > 0 the look-back window of a block stops
+        // at the left edge of its region, so the result is not bit-identical to the same blocks of a full CompressEx
+        // cImage must have the rowPitch and slicePitch that ComputePitch gives for its format and size
+
     enum CMSE_FLAGS : uint32_t
     {
         CMSE_DEFAULT = 0,
@@ -1075,6 +1174,16 @@ namespace DirectX
     DIRECTX_TEX_API void __cdecl SetWICFactory(_In_opt_ IWICImagingFactory* pWIC) noexcept;
 #endif
 
+    //---------------------------------------------------------------------------------
+    // Multithreading
+    using TaskParallelFor = std::function<void __cdecl(size_t count, size_t maxThreads, const std::function<void __cdecl(size_t)>& task)>;
+
+    DIRECTX_TEX_API void __cdecl SetTaskScheduler(_In_ TaskParallelFor parallelFor) noexcept;
+        // Replaces the built-in std::thread pool behind every multithreaded operation (such as TEX_COMPRESS_PARALLEL)
+        // parallelFor must call task(i) exactly once for each i in [0, count), on at most maxThreads threads counting
+        // the calling one (0 means no limit), and must not throw or return before all of those calls have returned.
+        // Set it before using the library from other threads; nullptr restores the built-in pool
+
     //---------------------------------------------------------------------------------
     // DDS helper functions
     DIRECTX_TEX_API HRESULT __cdecl EncodeDDSHeader(
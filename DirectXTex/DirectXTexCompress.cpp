@@ -11,10 +11,8 @@
 
 #include "DirectXTexP.h"
 
-#ifdef _OPENMP
-#include <omp.h>
-#pragma warning(disable : 4616 6993)
-#endif
+#include <chrono>
+#include <unordered_map>
 
 #include "BC.h"
 
@@ -31,7 +29,12 @@ namespace
         static_assert(static_cast<int>(TEX_COMPRESS_UNIFORM) == static_cast<int>(BC_FLAGS_UNIFORM), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
         static_assert(static_cast<int>(TEX_COMPRESS_BC7_USE_3SUBSETS) == static_cast<int>(BC_FLAGS_USE_3SUBSETS), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
         static_assert(static_cast<int>(TEX_COMPRESS_BC7_QUICK) == static_cast<int>(BC_FLAGS_FORCE_BC7_MODE6), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
-        return (compress & (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A | BC_FLAGS_UNIFORM | BC_FLAGS_USE_3SUBSETS | BC_FLAGS_FORCE_BC7_MODE6));
+        static_assert(static_cast<int>(TEX_COMPRESS_EFFORT_FAST) == static_cast<int>(BC_FLAGS_EFFORT_FAST), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
+        static_assert(static_cast<int>(TEX_COMPRESS_EFFORT_BEST) == static_cast<int>(BC_FLAGS_EFFORT_BEST), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
+        static_assert(static_cast<int>(TEX_COMPRESS_BC6H_QUICK) == static_cast<int>(BC_FLAGS_BC6H_QUICK), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
+        static_assert(static_cast<int>(TEX_COMPRESS_BC7_BATCH) == static_cast<int>(BC_FLAGS_BC7_BATCH), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
+        return (compress & (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A | BC_FLAGS_UNIFORM | BC_FLAGS_USE_3SUBSETS | BC_FLAGS_FORCE_BC7_MODE6
+            | BC_FLAGS_EFFORT_FAST | BC_FLAGS_EFFORT_BEST | BC_FLAGS_BC6H_QUICK | BC_FLAGS_BC7_BATCH));
     }
 
     constexpr TEX_FILTER_FLAGS GetSRGBFlags(_In_ TEX_COMPRESS_FLAGS compress) noexcept
@@ -67,23 +70,699 @@ namespace
         return true;
     }
 
+    inline bool DetermineSolidEncoder(_In_ DXGI_FORMAT format, _Out_ BC_ENCODE& pfEncodeSolid, _Out_ XMVECTOR& channelMask) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:    pfEncodeSolid = nullptr;                channelMask = g_XMSelect1111; break;
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:    pfEncodeSolid = D3DXEncodeSolidBC2;     channelMask = g_XMSelect1111; break;
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:    pfEncodeSolid = D3DXEncodeSolidBC3;     channelMask = g_XMSelect1111; break;
+        case DXGI_FORMAT_BC4_UNORM:         pfEncodeSolid = D3DXEncodeSolidBC4U;    channelMask = g_XMSelect1000; break;
+        case DXGI_FORMAT_BC4_SNORM:         pfEncodeSolid = D3DXEncodeSolidBC4S;    channelMask = g_XMSelect1000; break;
+        case DXGI_FORMAT_BC5_UNORM:         pfEncodeSolid = D3DXEncodeSolidBC5U;    channelMask = g_XMSelect1100; break;
+        case DXGI_FORMAT_BC5_SNORM:         pfEncodeSolid = D3DXEncodeSolidBC5S;    channelMask = g_XMSelect1100; break;
+        default:                            pfEncodeSolid = nullptr;                channelMask = g_XMSelect1111; return false;
+        }
+
+        return true;
+    }
+
+    // Decoder and channels used to measure the error of encoded blocks
+    inline void DetermineErrorDecoder(_In_ DXGI_FORMAT format, _Out_ BC_DECODE& pfDecode, _Out_ XMVECTOR& channelMask, _Out_ size_t& channels) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:    pfDecode = D3DXDecodeBC1;   channelMask = g_XMSelect1111;   channels = 4; break;
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:    pfDecode = D3DXDecodeBC2;   channelMask = g_XMSelect1111;   channels = 4; break;
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:    pfDecode = D3DXDecodeBC3;   channelMask = g_XMSelect1111;   channels = 4; break;
+        case DXGI_FORMAT_BC4_UNORM:         pfDecode = D3DXDecodeBC4U;  channelMask = g_XMSelect1000;   channels = 1; break;
+        case DXGI_FORMAT_BC4_SNORM:         pfDecode = D3DXDecodeBC4S;  channelMask = g_XMSelect1000;   channels = 1; break;
+        case DXGI_FORMAT_BC5_UNORM:         pfDecode = D3DXDecodeBC5U;  channelMask = g_XMSelect1100;   channels = 2; break;
+        case DXGI_FORMAT_BC5_SNORM:         pfDecode = D3DXDecodeBC5S;  channelMask = g_XMSelect1100;   channels = 2; break;
+        case DXGI_FORMAT_BC6H_UF16:         pfDecode = D3DXDecodeBC6HU; channelMask = g_XMSelect1110;   channels = 3; break;
+        case DXGI_FORMAT_BC6H_SF16:         pfDecode = D3DXDecodeBC6HS; channelMask = g_XMSelect1110;   channels = 3; break;
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:    pfDecode = D3DXDecodeBC7;   channelMask = g_XMSelect1111;   channels = 4; break;
+        default:                            pfDecode = nullptr;         channelMask = g_XMSelect1111;   channels = 4; break;
+        }
+    }
+
+    // Mode of an encoded BC6H or BC7 block, counting from 0 in the order of the format specification
+    uint32_t GetBlockMode(_In_ DXGI_FORMAT format, _In_ const uint8_t* pBC) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+            {
+                // Modes 0 and 1 have a 2-bit mode field, the others a 5-bit one
+                static const uint32_t s_modes[32] =
+                {
+                    0, 1, 2, 10, UINT32_MAX, UINT32_MAX, 3, 11,
+                    UINT32_MAX, UINT32_MAX, 4, 12, UINT32_MAX, UINT32_MAX, 5, 13,
+                    UINT32_MAX, UINT32_MAX, 6, UINT32_MAX, UINT32_MAX, UINT32_MAX, 7, UINT32_MAX,
+                    UINT32_MAX, UINT32_MAX, 8, UINT32_MAX, UINT32_MAX, UINT32_MAX, 9, UINT32_MAX,
+                };
+
+                const uint32_t field = ((pBC[0] & 0x3) < 2) ? (pBC[0] & 0x3u) : (pBC[0] & 0x1Fu);
+                return s_modes[field];
+            }
+
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            // The mode is the position of the lowest set bit
+            for (uint32_t mode = 0; mode < 8; ++mode)
+            {
+                if (pBC[0] & (1u << mode))
+                    return mode;
+            }
+            return UINT32_MAX;
+
+        default:
+            return 0;
+        }
+    }
+
+    inline bool IsBatchEncoded(_In_ DXGI_FORMAT format, _In_ uint32_t bcflags) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+            return true;
+
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            // The multi-block BC7 encoder searches fewer modes, so it is only used when asked for
+            return (bcflags & BC_FLAGS_BC7_BATCH) && !(bcflags & BC_FLAGS_FORCE_BC7_MODE6);
+
+        default:
+            return false;
+        }
+    }
+
+    // Encodes a single block, passing the error target to the BC6H and BC7 encoders. BC7 takes the
+    // 8-bit pixels instead of the XMVECTORs when the block was gathered as bytes.
+    inline void EncodeBlock(
+        _In_ DXGI_FORMAT format,
+        _In_ BC_ENCODE pfEncode,
+        _Out_ uint8_t* pDest,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor,
+        _In_opt_ const PackedVector::XMUBYTEN4* pBytes,
+        float errorTarget,
+        uint32_t bcflags) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC6H_UF16:
+            D3DXEncodeBC6HU(pDest, pColor, errorTarget, bcflags);
+            break;
+
+        case DXGI_FORMAT_BC6H_SF16:
+            D3DXEncodeBC6HS(pDest, pColor, errorTarget, bcflags);
+            break;
+
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            if (pBytes)
+                D3DXEncodeBC7FromRGBA8(pDest, pBytes, errorTarget, bcflags);
+            else
+                D3DXEncodeBC7(pDest, pColor, errorTarget, bcflags);
+            break;
+
+        default:
+            pfEncode(pDest, pColor, bcflags);
+            break;
+        }
+    }
+
+    // BC6H can encode DXGI_FORMAT_R16G16B16A16_FLOAT pixels as they are, unless an sRGB conversion is requested
+    inline bool IsEncodedFromHalf(_In_ DXGI_FORMAT format, _In_ DXGI_FORMAT srcFormat, _In_ TEX_FILTER_FLAGS srgb) noexcept
+    {
+        return (srcFormat == DXGI_FORMAT_R16G16B16A16_FLOAT)
+            && (format == DXGI_FORMAT_BC6H_UF16 || format == DXGI_FORMAT_BC6H_SF16)
+            && !(srgb & TEX_FILTER_SRGB);
+    }
+
+    // Maps the columns and rows of a 4x4 block to the source pixels, replicating pixels of partial blocks
+    inline void GetBlockPixelMap(
+        size_t pw,
+        size_t ph,
+        _Out_writes_(4) size_t* col,
+        _Out_writes_(4) size_t* row) noexcept
+    {
+        assert(pw > 0 && pw <= 4 && ph > 0 && ph <= 4);
+
+        static const size_t uSrc[] = { 0, 0, 0, 1 };
+        for (size_t k = 0; k < 4; ++k)
+        {
+            col[k] = (k < pw) ? k : col[uSrc[k]];
+            row[k] = (k < ph) ? k : row[uSrc[k]];
+        }
+    }
+
+    // 8-bit UNORM RGBA pixels can be gathered as bytes when the conversion to the BC format only moves channels around;
+    // R8 and R8G8 stay on the LoadScanline path, which scales them by a division rather than XMLoadUByteN4's reciprocal
+    inline bool IsEncodedFromBytes(_In_ DXGI_FORMAT format, _In_ DXGI_FORMAT srcFormat, _In_ TEX_FILTER_FLAGS srgb) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            break;
+
+        default:
+            return false;
+        }
+
+        switch (srcFormat)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            break;
+
+        default:
+            return false;
+        }
+
+        // ConvertScanline only applies a transfer function when exactly one side is sRGB
+        const bool srgbIn = (srgb & TEX_FILTER_SRGB_IN) || IsSRGB(srcFormat);
+        const bool srgbOut = (srgb & TEX_FILTER_SRGB_OUT) || IsSRGB(format);
+        return (srgbIn == srgbOut);
+    }
+
+    // Gathers a 4x4 block of 8-bit UNORM RGBA pixels straight from the source rows as RGBA bytes
+    inline void LoadBlockBytes(
+        _Out_writes_(NUM_PIXELS_PER_BLOCK) PackedVector::XMUBYTEN4* pBlock,
+        _In_ DXGI_FORMAT srcFormat,
+        _In_ const uint8_t* pSrc,
+        size_t rowPitch,
+        size_t pw,
+        size_t ph) noexcept
+    {
+        size_t col[4], row[4];
+        GetBlockPixelMap(pw, ph, col, row);
+
+        for (size_t t = 0; t < 4; ++t)
+        {
+            const uint8_t* sptr = pSrc + rowPitch * row[t];
+            PackedVector::XMUBYTEN4* dptr = &pBlock[t << 2];
+
+            switch (srcFormat)
+            {
+            case DXGI_FORMAT_B8G8R8A8_UNORM:
+            case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+                for (size_t s = 0; s < 4; ++s)
+                {
+                    const uint8_t* p = sptr + col[s] * 4;
+                    dptr[s] = PackedVector::XMUBYTEN4(p[2], p[1], p[0], p[3]);
+                }
+                break;
+
+            default:
+                for (size_t s = 0; s < 4; ++s)
+                {
+                    memcpy(&dptr[s], sptr + col[s] * 4, sizeof(PackedVector::XMUBYTEN4));
+                }
+                break;
+            }
+        }
+    }
+
+    // Gathers a 4x4 block of DXGI_FORMAT_R16G16B16A16_FLOAT pixels straight from the source rows, replicating
+    // pixels of partial blocks the same way as the XMVECTOR path
+    inline void LoadBlockHalf(
+        _Out_writes_(NUM_PIXELS_PER_BLOCK) PackedVector::XMHALF4* pBlock,
+        _In_ const uint8_t* pSrc,
+        size_t rowPitch,
+        size_t pw,
+        size_t ph) noexcept
+    {
+        size_t col[4], row[4];
+        GetBlockPixelMap(pw, ph, col, row);
+
+        for (size_t t = 0; t < 4; ++t)
+        {
+            auto sptr = reinterpret_cast<const PackedVector::XMHALF4*>(pSrc + rowPitch * row[t]);
+            for (size_t s = 0; s < 4; ++s)
+            {
+                pBlock[(t << 2) | s] = sptr[col[s]];
+            }
+        }
+    }
+
+    inline void EncodeBC6HFromHalf(
+        _In_ DXGI_FORMAT format,
+        _Out_writes_(16) uint8_t* pDest,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const PackedVector::XMHALF4* pBlock,
+        float errorTarget,
+        uint32_t bcflags) noexcept
+    {
+        if (format == DXGI_FORMAT_BC6H_SF16)
+            D3DXEncodeBC6HSFromHalf(pDest, pBlock, errorTarget, bcflags);
+        else
+            D3DXEncodeBC6HUFromHalf(pDest, pBlock, errorTarget, bcflags);
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Block deduplication
+    //-------------------------------------------------------------------------------------
+    struct BlockHash
+    {
+        uint64_t lo;
+        uint64_t hi;
+
+        bool operator==(const BlockHash& other) const noexcept { return (lo == other.lo) && (hi == other.hi); }
+    };
+
+    struct BlockHasher
+    {
+        size_t operator()(const BlockHash& key) const noexcept { return static_cast<size_t>(key.lo); }
+    };
+
+    inline uint64_t FinalizeHash(uint64_t h) noexcept
+    {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Hashes the contents of a block with two independently seeded 64-bit lanes. The hash only finds candidates;
+    // BlockCache compares the contents before it treats two blocks as identical.
+    inline BlockHash HashBlock(_In_reads_bytes_(size) const void* pData, size_t size) noexcept
+    {
+        assert((size % sizeof(uint64_t)) == 0);
+
+        auto ptr = static_cast<const uint8_t*>(pData);
+        uint64_t h1 = 0x9E3779B97F4A7C15ull ^ size;
+        uint64_t h2 = 0x632BE59BD9B4E019ull;
+        for (size_t i = 0; i < size; i += sizeof(uint64_t))
+        {
+            uint64_t v;
+            memcpy(&v, ptr + i, sizeof(uint64_t));
+
+            h1 = (h1 ^ v) * 0x100000001B3ull;
+            h1 ^= h1 >> 29;
+            h2 = (h2 + v) * 0xD6E8FEB86659FD93ull;
+            h2 = (h2 << 31) | (h2 >> 33);
+        }
+
+        BlockHash key;
+        key.lo = FinalizeHash(h1);
+        key.hi = FinalizeHash(h2 ^ key.lo);
+        return key;
+    }
+
+    // Encoded blocks of one compression call, keyed by the block contents after conversion. It is
+    // shared by every image of a set and every thread, so duplicates anywhere in a chain are found.
+    // Each shard keeps a copy of the contents of at most MAX_BLOCKS_PER_SHARD blocks and is emptied
+    // when it fills up, so the cache never holds more than about 20 MB.
+    class BlockCache
+    {
+    public:
+        static constexpr size_t MAX_SOURCE_SIZE = sizeof(XMVECTOR) * NUM_PIXELS_PER_BLOCK;
+
+        BlockCache() = default;
+
+        BlockCache(const BlockCache&) = delete;
+        BlockCache& operator=(const BlockCache&) = delete;
+
+        // Copies the encoding of a block with the same contents to pDest, if one has been encoded already
+        bool Find(
+            const BlockHash& key,
+            _In_reads_bytes_(size) const void* pSource,
+            size_t size,
+            _Out_writes_(blocksize) uint8_t* pDest,
+            size_t blocksize) noexcept
+        {
+            Shard& shard = m_shards[key.hi % NUM_SHARDS];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            auto it = shard.blocks.find(key);
+            if (it == shard.blocks.end()
+                || it->second.size != size
+                || memcmp(&shard.sources[it->second.offset], pSource, size) != 0)
+                return false;
+
+            memcpy(pDest, it->second.encoded, blocksize);
+            return true;
+        }
+
+        // Records a block as the encoder wrote it, before any rate optimization, so a duplicate can be
+        // optimized against its own neighbours
+        void Insert(
+            const BlockHash& key,
+            _In_reads_bytes_(size) const void* pSource,
+            size_t size,
+            _In_reads_(blocksize) const uint8_t* pEncoded,
+            size_t blocksize) noexcept
+        {
+            assert(size <= MAX_SOURCE_SIZE);
+            assert(blocksize <= sizeof(Entry::encoded));
+
+            Shard& shard = m_shards[key.hi % NUM_SHARDS];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            if (shard.blocks.size() >= MAX_BLOCKS_PER_SHARD)
+            {
+                shard.blocks.clear();
+            }
+
+            const size_t offset = shard.blocks.size() * MAX_SOURCE_SIZE;
+            try
+            {
+                if (shard.sources.size() < offset + MAX_SOURCE_SIZE)
+                {
+                    shard.sources.resize(offset + MAX_SOURCE_SIZE);
+                }
+
+                Entry entry = {};
+                memcpy(entry.encoded, pEncoded, blocksize);
+                entry.offset = offset;
+                entry.size = size;
+                if (!shard.blocks.emplace(key, entry).second)
+                    return;
+            }
+            catch (...)
+            {
+                // The cache only saves work, so a block that cannot be recorded is simply not shared
+                return;
+            }
+
+            memcpy(&shard.sources[offset], pSource, size);
+        }
+
+    private:
+        static constexpr size_t NUM_SHARDS = 16;
+        static constexpr size_t MAX_BLOCKS_PER_SHARD = 4096;
+
+        struct Entry
+        {
+            uint8_t encoded[16];
+            size_t offset;
+            size_t size;
+        };
+
+        struct Shard
+        {
+            std::mutex mutex;
+            std::unordered_map<BlockHash, Entry, BlockHasher> blocks;
+            std::vector<uint8_t> sources;
+        };
+
+        Shard m_shards[NUM_SHARDS];
+    };
+
+    //-------------------------------------------------------------------------------------
+    // Gathers CompressStats as block rows finish, on whichever threads encoded them
+    class StatsCollector
+    {
+    public:
+        StatsCollector(_Inout_ CompressStats& stats, _In_reads_(nimages) const Image* images, size_t nimages) noexcept :
+            m_stats(stats),
+            m_images(images),
+            m_nimages(nimages),
+            m_start(std::chrono::steady_clock::now())
+        {
+            double* imageSeconds = stats.imageSeconds;
+            stats = {};
+            stats.imageSeconds = imageSeconds;
+
+            if (imageSeconds)
+            {
+                std::fill(imageSeconds, imageSeconds + nimages, 0.0);
+            }
+        }
+
+        StatsCollector(const StatsCollector&) = delete;
+        StatsCollector& operator=(const StatsCollector&) = delete;
+
+        // Adds the blocks of a row of 'image', which must be one of the images the collector was created with
+        void Add(const Image& image, const CompressStats& counts, double seconds) noexcept
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_stats.blocks += counts.blocks;
+            m_stats.solidBlocks += counts.solidBlocks;
+            m_stats.cachedBlocks += counts.cachedBlocks;
+            m_stats.withinTargetBlocks += counts.withinTargetBlocks;
+            m_stats.bc1ThreeColor += counts.bc1ThreeColor;
+            m_stats.bc1FourColor += counts.bc1FourColor;
+
+            for (size_t i = 0; i < std::size(m_stats.modes); ++i)
+            {
+                m_stats.modes[i] += counts.modes[i];
+            }
+
+            for (size_t i = 0; i < std::size(m_stats.partitions2); ++i)
+            {
+                m_stats.partitions2[i] += counts.partitions2[i];
+                m_stats.partitions3[i] += counts.partitions3[i];
+            }
+
+            for (size_t i = 0; i < std::size(m_stats.rotations); ++i)
+            {
+                m_stats.rotations[i] += counts.rotations[i];
+            }
+
+            const auto index = static_cast<size_t>(&image - m_images);
+            if (m_stats.imageSeconds && index < m_nimages)
+            {
+                m_stats.imageSeconds[index] += seconds;
+            }
+
+            m_stats.busySeconds += seconds;
+
+            try
+            {
+                m_threads[std::this_thread::get_id()] += seconds;
+            }
+            catch (...)
+            {
+                // Only the per-thread figures are lost
+            }
+        }
+
+        // Fills in the figures that cover the whole call
+        void Finish() noexcept
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_stats.seconds = Elapsed(m_start);
+            m_stats.threads = m_threads.size();
+            for (const auto& it : m_threads)
+            {
+                m_stats.maxThreadSeconds = std::max(m_stats.maxThreadSeconds, it.second);
+            }
+        }
+
+        static double Elapsed(std::chrono::steady_clock::time_point start) noexcept
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+    private:
+        std::mutex m_mutex;
+        CompressStats& m_stats;
+        const Image* m_images;
+        size_t m_nimages;
+        std::chrono::steady_clock::time_point m_start;
+        std::unordered_map<std::thread::id, double> m_threads;
+    };
+
+    // Encodes a batch of BC1 or BC7 blocks whose destinations need not be contiguous. A partial
+    // batch is padded with copies of its last block so every block goes through the same encoder.
+    inline void EncodeBatch(
+        _In_ DXGI_FORMAT format,
+        _In_reads_(NUM_BLOCKS_PER_BATCH) uint8_t* const* pDest,
+        _Inout_updates_all_(NUM_PIXELS_PER_BLOCK * NUM_BLOCKS_PER_BATCH) XMVECTOR* pColor,
+        size_t count,
+        float threshold,
+        float errorTarget,
+        uint32_t bcflags) noexcept
+    {
+        assert(count > 0 && count <= NUM_BLOCKS_PER_BATCH);
+
+        for (size_t j = count; j < NUM_BLOCKS_PER_BATCH; ++j)
+        {
+            memcpy(&pColor[j * NUM_PIXELS_PER_BLOCK], &pColor[(count - 1) * NUM_PIXELS_PER_BLOCK], sizeof(XMVECTOR) * NUM_PIXELS_PER_BLOCK);
+        }
+
+        uint8_t bc[16 * NUM_BLOCKS_PER_BATCH];
+        size_t blocksize;
+        switch (format)
+        {
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            D3DXEncodeBC7Batch(bc, pColor, errorTarget, bcflags);
+            blocksize = 16;
+            break;
+
+        default:
+            D3DXEncodeBC1Batch(bc, pColor, threshold, bcflags);
+            blocksize = 8;
+            break;
+        }
+
+        for (size_t j = 0; j < count; ++j)
+        {
+            memcpy(pDest[j], &bc[j * blocksize], blocksize);
+        }
+    }
+
+
+    // Decodes the scanlines of a block row once, in full, into 4x4 block order with the pixels of partial
+    // blocks replicated, and converts them for the BC format. pScanline holds one decoded scanline. The row
+    // is the 'width' pixels starting at pSrc, which may be a span of the image's blocks.
+    bool LoadBlockRow(
+        _Out_writes_(nBlocks * NUM_PIXELS_PER_BLOCK) XMVECTOR* pBlocks,
+        _Out_writes_(nBlocks * 4) XMVECTOR* pScanline,
+        size_t nBlocks,
+        size_t width,
+        const Image& image,
+        _In_ const uint8_t* pSrc,
+        size_t ph,
+        _In_ DXGI_FORMAT format,
+        _In_ TEX_FILTER_FLAGS flags) noexcept
+    {
+        assert(nBlocks > 0 && ph > 0);
+
+        const uint8_t *pEnd = image.pixels + image.slicePitch;
+        const size_t rowPitch = image.rowPitch;
+        const size_t last = nBlocks - 1;
+
+        size_t col[4], row[4];
+        GetBlockPixelMap(width - last * 4, ph, col, row);
+
+        for (size_t t = 0; t < ph; ++t)
+        {
+            const uint8_t *sptr = pSrc + rowPitch * t;
+            const ptrdiff_t bytesLeft = pEnd - sptr;
+            assert(bytesLeft > 0);
+            if (!LoadScanline(pScanline, width, sptr, std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft)), image.format))
+                return false;
+
+            for (size_t bx = 0; bx < last; ++bx)
+            {
+                memcpy(&pBlocks[bx * NUM_PIXELS_PER_BLOCK + (t << 2)], &pScanline[bx * 4], sizeof(XMVECTOR) * 4);
+            }
+
+            for (size_t s = 0; s < 4; ++s)
+            {
+                pBlocks[last * NUM_PIXELS_PER_BLOCK + (t << 2) + s] = pScanline[last * 4 + col[s]];
+            }
+        }
+
+        for (size_t t = ph; t < 4; ++t)
+        {
+            for (size_t bx = 0; bx < nBlocks; ++bx)
+            {
+                memcpy(&pBlocks[bx * NUM_PIXELS_PER_BLOCK + (t << 2)], &pBlocks[bx * NUM_PIXELS_PER_BLOCK + (row[t] << 2)], sizeof(XMVECTOR) * 4);
+            }
+        }
+
+        ConvertScanline(pBlocks, nBlocks * NUM_PIXELS_PER_BLOCK, format, image.format, flags);
+
+        return true;
+    }
+
+    // XMVECTORs of staging needed to compress a block row of an image 'width' pixels wide
+    inline size_t GetStagingSize(size_t width) noexcept
+    {
+        return ((width + 3) / 4) * (NUM_PIXELS_PER_BLOCK + 4);
+    }
+
+    // Staging for the parallel compressor, kept by each thread so it is allocated once rather than per task
+    XMVECTOR* GetThreadStaging(size_t count) noexcept
+    {
+        thread_local ScopedAlignedArrayXMVECTOR s_staging;
+        thread_local size_t s_count = 0;
 
-    //-------------------------------------------------------------------------------------
-    HRESULT CompressBC(
-        const Image& image,
-        const Image& result,
+        if (count > s_count)
+        {
+            s_staging = make_AlignedArrayXMVECTOR(count);
+            s_count = (s_staging) ? count : 0;
+        }
+
+        return s_staging.get();
+    }
+
+    // Formats whose blocks can be rate-distortion optimized after encoding
+    inline bool IsRateOptimized(_In_ DXGI_FORMAT format) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    // How the blocks of an image are encoded into a BC format
+    struct BCEncoder
+    {
+        XMVECTOR solidMask;
+        XMVECTOR errorMask;
+        BC_ENCODE pfEncode;
+        BC_DECODE pfDecode;
+        BC_ENCODE pfEncodeSolid;
+        size_t sbpp;
+        size_t blocksize;
+        size_t errorChannels;
+        TEX_FILTER_FLAGS cflags;
+        TEX_FILTER_FLAGS srgb;
+        uint32_t bcflags;
+        float threshold;
+        float errorTarget;
+        float rdoLambda;
+        BlockCache* pCache;
+        StatsCollector* pStats;
+        DXGI_FORMAT cformat;
+        bool solid;
+        bool batched;
+        bool fromHalf;
+        bool fromBytes;
+
+        // Blocks neither gathered as bytes nor as half-floats are decoded a block row at a time into staging
+        bool IsStaged() const noexcept { return !fromHalf && !fromBytes; }
+    };
+
+    HRESULT DetermineEncoder(
+        _In_ DXGI_FORMAT format,
+        _In_ DXGI_FORMAT cformat,
         uint32_t bcflags,
         TEX_FILTER_FLAGS srgb,
         float threshold,
-        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+        float errorTarget,
+        float rdoLambda,
+        _Out_ BCEncoder& encoder) noexcept
     {
-        if (!image.pixels || !result.pixels)
-            return E_POINTER;
-
-        assert(image.width == result.width);
-        assert(image.height == result.height);
-
-        const DXGI_FORMAT format = image.format;
         size_t sbpp = BitsPerPixel(format);
         if (!sbpp)
             return E_FAIL;
@@ -95,110 +774,740 @@ namespace
         }
 
         // Round to bytes
-        sbpp = (sbpp + 7) / 8;
+        encoder.sbpp = (sbpp + 7) / 8;
+
+        // Determine BC format encoder
+        if (!DetermineEncoderSettings(cformat, encoder.pfEncode, encoder.blocksize, encoder.cflags))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        // Blocks where every pixel has the same value are encoded from tables
+        encoder.solid = DetermineSolidEncoder(cformat, encoder.pfEncodeSolid, encoder.solidMask);
+
+        // Block errors for CompressOptions::blockInfo are measured on the decoded block
+        DetermineErrorDecoder(cformat, encoder.pfDecode, encoder.errorMask, encoder.errorChannels);
+
+        // BC1 blocks (and BC7 blocks for TEX_COMPRESS_BC7_BATCH) are gathered and encoded NUM_BLOCKS_PER_BATCH at a time
+        encoder.batched = IsBatchEncoded(cformat, bcflags);
+        encoder.fromHalf = IsEncodedFromHalf(cformat, format, srgb);
+        encoder.fromBytes = IsEncodedFromBytes(cformat, format, srgb);
+
+        encoder.srgb = srgb;
+        encoder.bcflags = bcflags;
+        encoder.threshold = threshold;
+        encoder.errorTarget = errorTarget;
+        encoder.rdoLambda = (IsRateOptimized(cformat)) ? rdoLambda : 0.f;
+        encoder.pCache = nullptr;
+        encoder.pStats = nullptr;
+        encoder.cformat = cformat;
+
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Rate-distortion optimization
+    //-------------------------------------------------------------------------------------
+    // Earlier blocks of the same row whose bits a block may take over
+    constexpr size_t RDO_WINDOW = 8;
+
+    // Bits an LZ coder is assumed to spend on a literal byte, and on a match of at least RDO_MIN_MATCH bytes
+    constexpr float RDO_LITERAL_BITS = 8.f;
+    constexpr float RDO_MATCH_BITS = 24.f;
+    constexpr size_t RDO_MIN_MATCH = 3;
+
+    inline uint32_t GetBlockBits(_In_ const uint8_t* pBC, size_t start, size_t count) noexcept
+    {
+        uint32_t value = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t bit = start + i;
+            value |= uint32_t((pBC[bit >> 3] >> (bit & 7)) & 1) << i;
+        }
+        return value;
+    }
+
+    inline void SetBlockBits(_Inout_ uint8_t* pBC, size_t start, size_t count, uint32_t value) noexcept
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t bit = start + i;
+            const auto mask = static_cast<uint8_t>(1u << (bit & 7));
+            if ((value >> i) & 1)
+                pBC[bit >> 3] |= mask;
+            else
+                pBC[bit >> 3] &= static_cast<uint8_t>(~mask);
+        }
+    }
+
+    inline void CopyBlockBits(_Inout_ uint8_t* pBC, _In_ const uint8_t* pSrc, size_t start, size_t end) noexcept
+    {
+        for (size_t bit = start; bit < end; bit += 16)
+        {
+            const size_t count = std::min<size_t>(16, end - bit);
+            SetBlockBits(pBC, bit, count, GetBlockBits(pSrc, bit, count));
+        }
+    }
+
+    // One independently coded part of a block: endpoint bits [start, indexStart) and index bits [indexStart, end)
+    struct BlockPart
+    {
+        size_t start;
+        size_t indexStart;
+        size_t end;
+        size_t indexBits;
+        bool anchor;        // The first pixel's index has an implicit high bit of 0
+        bool mode6;         // Endpoints and indices can only be swapped between BC7 mode 6 blocks
+        bool alphaTest;     // The pixels the encoder made transparent (BC1 with a threshold) must stay so
+        XMVECTOR mask;      // Channels decoded from this part
+    };
+
+    size_t GetBlockParts(_In_ DXGI_FORMAT format, _Out_writes_(2) BlockPart* pParts, _Out_ BC_DECODE& pfDecode) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+            pfDecode = D3DXDecodeBC1;
+            pParts[0] = { 0, 32, 64, 2, false, false, true, g_XMSelect1111 };
+            return 1;
+
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+            pfDecode = D3DXDecodeBC3;
+            pParts[0] = { 0, 16, 64, 3, false, false, false, g_XMMaskW };
+            pParts[1] = { 64, 96, 128, 2, false, false, false, g_XMMask3 };
+            return 2;
+
+        default:
+            pfDecode = D3DXDecodeBC7;
+            pParts[0] = { 0, 65, 128, 4, true, true, false, g_XMSelect1111 };
+            return 1;
+        }
+    }
+
+    inline bool IsBC7Mode6(_In_ const uint8_t* pBC) noexcept
+    {
+        return (pBC[0] & 0x7F) == 0x40;
+    }
+
+    inline bool IsTransparent(FXMVECTOR color) noexcept
+    {
+        return XMVectorGetW(color) <= 0.f;
+    }
+
+    // Whether a candidate keeps exactly the transparent pixels of the decoded original
+    bool SameTransparency(
+        _In_ BC_DECODE pfDecode,
+        _In_ const uint8_t* pBC,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pOriginal) noexcept
+    {
+        XM_ALIGNED_DATA(16) XMVECTOR decoded[NUM_PIXELS_PER_BLOCK];
+        pfDecode(decoded, pBC);
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            if (IsTransparent(decoded[i]) != IsTransparent(pOriginal[i]))
+                return false;
+        }
+
+        return true;
+    }
+
+    // Squared error of a decoded block against its source in 8-bit steps, over the channels in mask
+    float GetBlockError(
+        _In_ BC_DECODE pfDecode,
+        _In_ const uint8_t* pBC,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor,
+        _In_ FXMVECTOR mask) noexcept
+    {
+        XM_ALIGNED_DATA(16) XMVECTOR decoded[NUM_PIXELS_PER_BLOCK];
+        pfDecode(decoded, pBC);
+
+        const XMVECTOR scale = XMVectorAndInt(XMVectorReplicate(255.f), mask);
+        XMVECTOR sum = XMVectorZero();
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            const XMVECTOR diff = XMVectorMultiply(XMVectorSubtract(decoded[i], pColor[i]), scale);
+            sum = XMVectorMultiplyAdd(diff, diff, sum);
+        }
+
+        return XMVectorGetX(XMVector4Dot(sum, g_XMOne));
+    }
+
+    // Bits an LZ coder is expected to spend on bytes [first, last) of a candidate for the block at pBlock. Only
+    // matches with the same bytes of the preceding blocks are looked for, since those are the repeats RDO creates.
+    float EstimateBits(
+        _In_ const uint8_t* pCandidate,
+        size_t first,
+        size_t last,
+        _In_ const uint8_t* pBlock,
+        size_t nWindow,
+        size_t blocksize) noexcept
+    {
+        float bits = 0.f;
+        size_t i = first;
+        while (i < last)
+        {
+            size_t longest = 0;
+            for (size_t k = 1; k <= nWindow; ++k)
+            {
+                const uint8_t* pPrev = pBlock - k * blocksize;
+
+                size_t len = 0;
+                while ((i + len < last) && (pCandidate[i + len] == pPrev[i + len]))
+                    ++len;
+
+                longest = std::max(longest, len);
+            }
+
+            if (longest >= RDO_MIN_MATCH)
+            {
+                bits += RDO_MATCH_BITS;
+                i += longest;
+            }
+            else
+            {
+                bits += RDO_LITERAL_BITS;
+                ++i;
+            }
+        }
+
+        return bits;
+    }
+
+    // Rewrites the index bits of a part with the nearest palette entry for each pixel. The palette is read back
+    // by decoding a probe block whose first pixels use each index in turn, so it matches the decoder exactly.
+    // With pOriginal, only entries as transparent as the decoded original pixel are chosen.
+    void SelectIndices(
+        _In_ BC_DECODE pfDecode,
+        _Inout_updates_bytes_(16) uint8_t* pBC,
+        const BlockPart& part,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor,
+        _In_reads_opt_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pOriginal) noexcept
+    {
+        const size_t nEntries = size_t(1) << part.indexBits;
+        assert(nEntries <= NUM_PIXELS_PER_BLOCK);
+
+        uint8_t probe[16];
+        memcpy(probe, pBC, sizeof(probe));
+
+        size_t bit = part.indexStart;
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            const size_t count = (part.anchor && i == 0) ? part.indexBits - 1 : part.indexBits;
+            SetBlockBits(probe, bit, count, (i < nEntries) ? uint32_t(i) : 0u);
+            bit += count;
+        }
+
+        XM_ALIGNED_DATA(16) XMVECTOR palette[NUM_PIXELS_PER_BLOCK];
+        pfDecode(palette, probe);
+
+        bit = part.indexStart;
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            const size_t count = (part.anchor && i == 0) ? part.indexBits - 1 : part.indexBits;
+            const size_t nChoices = size_t(1) << count;
+
+            uint32_t best = 0;
+            float bestError = FLT_MAX;
+            for (size_t j = 0; j < nChoices; ++j)
+            {
+                if (pOriginal && IsTransparent(palette[j]) != IsTransparent(pOriginal[i]))
+                    continue;
+
+                const XMVECTOR diff = XMVectorAndInt(XMVectorSubtract(palette[j], pColor[i]), part.mask);
+                const float error = XMVectorGetX(XMVector4Dot(diff, diff));
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best = uint32_t(j);
+                }
+            }
+
+            SetBlockBits(pBC, bit, count, best);
+            bit += count;
+        }
+    }
+
+    // Trades error for compressibility: each part of the block may take over all of an earlier block's bits, its
+    // endpoints (with the indices chosen again) or its indices, whichever lowers error + lambda * estimated bits
+    void OptimizeBlockRate(
+        _In_ DXGI_FORMAT format,
+        _Inout_ uint8_t* pBlock,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor,
+        _In_ const uint8_t* pRowStart,
+        size_t blocksize,
+        float lambda) noexcept
+    {
+        const size_t nWindow = std::min<size_t>(RDO_WINDOW, size_t(pBlock - pRowStart) / blocksize);
+        if (!nWindow)
+            return;
+
+        BlockPart parts[2];
+        BC_DECODE pfDecode;
+        const size_t nParts = GetBlockParts(format, parts, pfDecode);
+
+        uint8_t best[16];
+        memcpy(best, pBlock, blocksize);
+
+        XM_ALIGNED_DATA(16) XMVECTOR original[NUM_PIXELS_PER_BLOCK];
+        pfDecode(original, pBlock);
+
+        for (size_t n = 0; n < nParts; ++n)
+        {
+            const BlockPart& part = parts[n];
+            const size_t first = part.start / 8;
+            const size_t last = (part.end + 7) / 8;
+
+            float bestCost = GetBlockError(pfDecode, best, pColor, part.mask)
+                + lambda * EstimateBits(best, first, last, pBlock, nWindow, blocksize);
+
+            uint8_t current[16];
+            memcpy(current, best, blocksize);
+
+            for (size_t k = 1; k <= nWindow; ++k)
+            {
+                const uint8_t* pPrev = pBlock - k * blocksize;
+
+                uint8_t candidates[3][16];
+                size_t nCandidates = 0;
+
+                memcpy(candidates[nCandidates], current, blocksize);
+                CopyBlockBits(candidates[nCandidates++], pPrev, part.start, part.end);
+
+                if (!part.mode6 || IsBC7Mode6(pPrev))
+                {
+                    memcpy(candidates[nCandidates], current, blocksize);
+                    CopyBlockBits(candidates[nCandidates], pPrev, part.start, part.indexStart);
+                    SelectIndices(pfDecode, candidates[nCandidates++], part, pColor, (part.alphaTest) ? original : nullptr);
+
+                    if (!part.mode6 || IsBC7Mode6(current))
+                    {
+                        memcpy(candidates[nCandidates], current, blocksize);
+                        CopyBlockBits(candidates[nCandidates++], pPrev, part.indexStart, part.end);
+                    }
+                }
+
+                for (size_t j = 0; j < nCandidates; ++j)
+                {
+                    if (part.alphaTest && !SameTransparency(pfDecode, candidates[j], original))
+                        continue;
+
+                    const float cost = GetBlockError(pfDecode, candidates[j], pColor, part.mask)
+                        + lambda * EstimateBits(candidates[j], first, last, pBlock, nWindow, blocksize);
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        memcpy(best, candidates[j], blocksize);
+                    }
+                }
+            }
+        }
+
+        memcpy(pBlock, best, blocksize);
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Where the bits of a finished block came from
+    enum BLOCK_SOURCE : uint32_t
+    {
+        BLOCK_ENCODED = 0,
+        BLOCK_SOLID,
+        BLOCK_CACHED,
+    };
+
+    inline bool IsSearchEncoded(_In_ DXGI_FORMAT format) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    inline int HalfToSteps(float value) noexcept
+    {
+        const PackedVector::HALF h = PackedVector::XMConvertFloatToHalf(value);
+        return (h & 0x8000) ? -int(h & 0x7FFF) : int(h);
+    }
+
+    // Error of a decoded BC6H or BC7 block in the units of CompressOptions::errorTarget: the mean over its 16
+    // pixels of the squared error summed over RGBA in 8-bit steps (BC7) or over RGB in half-float steps (BC6H)
+    float GetTargetError(
+        _In_ DXGI_FORMAT format,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pDecoded,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor) noexcept
+    {
+        float error = 0.f;
+        if (format == DXGI_FORMAT_BC6H_UF16 || format == DXGI_FORMAT_BC6H_SF16)
+        {
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+            {
+                XMFLOAT4A decoded, color;
+                XMStoreFloat4A(&decoded, pDecoded[i]);
+                XMStoreFloat4A(&color, pColor[i]);
+
+                const float dr = float(HalfToSteps(decoded.x) - HalfToSteps(color.x));
+                const float dg = float(HalfToSteps(decoded.y) - HalfToSteps(color.y));
+                const float db = float(HalfToSteps(decoded.z) - HalfToSteps(color.z));
+                error += dr * dr + dg * dg + db * db;
+            }
+        }
+        else
+        {
+            const XMVECTOR scale = XMVectorReplicate(255.f);
+            XMVECTOR sum = XMVectorZero();
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+            {
+                const XMVECTOR diff = XMVectorMultiply(XMVectorSubtract(pDecoded[i], pColor[i]), scale);
+                sum = XMVectorMultiplyAdd(diff, diff, sum);
+            }
+            error = XMVectorGetX(XMVector4Dot(sum, g_XMOne));
+        }
+
+        return error / float(NUM_PIXELS_PER_BLOCK);
+    }
+
+    // Adds a finished block to the mode, partition and rotation histograms
+    void CountBlock(
+        _In_ DXGI_FORMAT format,
+        _In_ const uint8_t* pBC,
+        BLOCK_SOURCE source,
+        _Inout_ CompressStats& counts) noexcept
+    {
+        ++counts.blocks;
+        if (source == BLOCK_SOLID)
+            ++counts.solidBlocks;
+        else if (source == BLOCK_CACHED)
+            ++counts.cachedBlocks;
+
+        const uint32_t mode = GetBlockMode(format, pBC);
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+            // color0 <= color1 selects the 3-color palette
+            if (GetBlockBits(pBC, 0, 16) <= GetBlockBits(pBC, 16, 16))
+                ++counts.bc1ThreeColor;
+            else
+                ++counts.bc1FourColor;
+            break;
+
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+            if (mode < 14)
+            {
+                ++counts.modes[mode];
+
+                // Modes 0-9 have two regions, with the shape in the last 5 header bits
+                if (mode < 10)
+                    ++counts.partitions2[GetBlockBits(pBC, 77, 5)];
+            }
+            break;
+
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            if (mode < 8)
+            {
+                ++counts.modes[mode];
+
+                // The partition or rotation bits directly follow the mode bits
+                switch (mode)
+                {
+                case 0: ++counts.partitions3[GetBlockBits(pBC, 1, 4)]; break;
+                case 1: ++counts.partitions2[GetBlockBits(pBC, 2, 6)]; break;
+                case 2: ++counts.partitions3[GetBlockBits(pBC, 3, 6)]; break;
+                case 3: ++counts.partitions2[GetBlockBits(pBC, 4, 6)]; break;
+                case 4: ++counts.rotations[GetBlockBits(pBC, 5, 2)]; break;
+                case 5: ++counts.rotations[GetBlockBits(pBC, 6, 2)]; break;
+                case 7: ++counts.partitions2[GetBlockBits(pBC, 8, 6)]; break;
+                default: break;
+                }
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // Measures a finished block for CompressOptions::blockInfo and counts it for CompressOptions::stats. Only the
+    // pw x ph pixels inside the image count towards its error, not the ones replicated to fill a partial block.
+    void RecordBlock(
+        const BCEncoder& encoder,
+        _In_ const uint8_t* pBC,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor,
+        size_t pw,
+        size_t ph,
+        BLOCK_SOURCE source,
+        _Out_opt_ CompressBlockInfo* pInfo,
+        _Inout_opt_ CompressStats* pCounts) noexcept
+    {
+        const bool target = pCounts && source == BLOCK_ENCODED && encoder.errorTarget > 0.f && IsSearchEncoded(encoder.cformat);
+        if (pInfo || target)
+        {
+            XM_ALIGNED_DATA(16) XMVECTOR decoded[NUM_PIXELS_PER_BLOCK];
+            encoder.pfDecode(decoded, pBC);
+
+            if (pInfo)
+            {
+                XMVECTOR sum = XMVectorZero();
+                for (size_t y = 0; y < ph; ++y)
+                {
+                    for (size_t x = 0; x < pw; ++x)
+                    {
+                        const size_t i = (y << 2) + x;
+                        const XMVECTOR diff = XMVectorAndInt(XMVectorSubtract(decoded[i], pColor[i]), encoder.errorMask);
+                        sum = XMVectorMultiplyAdd(diff, diff, sum);
+                    }
+                }
+
+                pInfo->mse = XMVectorGetX(XMVector4Dot(sum, g_XMOne)) / float(pw * ph * encoder.errorChannels);
+                pInfo->mode = GetBlockMode(encoder.cformat, pBC);
+            }
+
+            if (target && GetTargetError(encoder.cformat, decoded, pColor) <= encoder.errorTarget)
+            {
+                ++pCounts->withinTargetBlocks;
+            }
+        }
 
-        uint8_t *pDest = result.pixels;
+        if (pCounts)
+        {
+            CountBlock(encoder.cformat, pBC, source, *pCounts);
+        }
+    }
+
+    // Finishes a batch once it is encoded: the blocks become available to their duplicates, then rate
+    // optimization runs in row order and they are recorded
+    void FinishBatch(
+        const BCEncoder& encoder,
+        _In_ const uint8_t* pRowStart,
+        _In_reads_(count) const BlockHash* pKeys,
+        _In_reads_(count) uint8_t* const* pDest,
+        _In_reads_(count) CompressBlockInfo* const* pInfo,
+        _In_reads_(count) const size_t* pWidths,
+        size_t ph,
+        _In_reads_(count * NUM_PIXELS_PER_BLOCK) const XMVECTOR* pColor,
+        size_t count,
+        _Inout_opt_ CompressStats* pCounts) noexcept
+    {
+        for (size_t j = 0; j < count; ++j)
+        {
+            if (encoder.pCache)
+            {
+                encoder.pCache->Insert(pKeys[j], &pColor[j * NUM_PIXELS_PER_BLOCK], sizeof(XMVECTOR) * NUM_PIXELS_PER_BLOCK, pDest[j], encoder.blocksize);
+            }
+
+            if (encoder.rdoLambda > 0.f)
+            {
+                OptimizeBlockRate(encoder.cformat, pDest[j], &pColor[j * NUM_PIXELS_PER_BLOCK], pRowStart, encoder.blocksize, encoder.rdoLambda);
+            }
+
+            if (pInfo[j] || pCounts)
+            {
+                RecordBlock(encoder, pDest[j], &pColor[j * NUM_PIXELS_PER_BLOCK], pWidths[j], ph, BLOCK_ENCODED, pInfo[j], pCounts);
+            }
+        }
+    }
 
-        // Determine BC format encoder
-        BC_ENCODE pfEncode;
-        size_t blocksize;
-        TEX_FILTER_FLAGS cflags;
-        if (!DetermineEncoderSettings(result.format, pfEncode, blocksize, cflags))
-            return HRESULT_E_NOT_SUPPORTED;
+    // Encodes nBlocks blocks of a block row, starting at firstBlock. pStaging holds GetStagingSize(image.width)
+    // XMVECTORs when encoder.IsStaged(), and pInfo receives the error and mode of each block.
+    HRESULT CompressBlockRow(
+        const Image& image,
+        const Image& result,
+        const BCEncoder& encoder,
+        size_t blockRow,
+        size_t firstBlock,
+        size_t nBlocks,
+        _Inout_opt_ XMVECTOR* pStaging,
+        _Out_writes_opt_(nBlocks) CompressBlockInfo* pInfo) noexcept
+    {
+        const size_t h = blockRow * 4;
+        assert(h < image.height);
+        assert(nBlocks > 0 && (firstBlock + nBlocks) * 4 < image.width + 4);
 
-        XM_ALIGNED_DATA(16) XMVECTOR temp[16];
-        const uint8_t *pSrc = image.pixels;
-        const uint8_t *pEnd = image.pixels + image.slicePitch;
+        const DXGI_FORMAT cformat = result.format;
         const size_t rowPitch = image.rowPitch;
-        for (size_t h = 0; h < image.height; h += 4)
+        const size_t x = firstBlock * 4;
+        const size_t width = std::min<size_t>(nBlocks * 4, image.width - x);
+        const size_t ph = std::min<size_t>(4, image.height - h);
+        const uint8_t *pSrc = image.pixels + rowPitch * h + x * encoder.sbpp;
+        uint8_t *pDest = result.pixels + result.rowPitch * blockRow + firstBlock * encoder.blocksize;
+        const bool rdo = (encoder.rdoLambda > 0.f);
+        const uint32_t bcflags = encoder.bcflags;
+
+        // Counts for CompressOptions::stats are kept for the row and added once it is done
+        const auto start = std::chrono::steady_clock::now();
+        CompressStats counts = {};
+        CompressStats* pCounts = (encoder.pStats) ? &counts : nullptr;
+
+        const bool staged = encoder.IsStaged();
+        if (staged)
         {
-            if (statusCallback)
-            {
-                if (!statusCallback(h, image.height))
-                {
-                    return E_ABORT;
-                }
-            }
+            if (!pStaging)
+                return E_OUTOFMEMORY;
+
+            if (!LoadBlockRow(pStaging, pStaging + nBlocks * NUM_PIXELS_PER_BLOCK, nBlocks, width, image, pSrc, ph, cformat, encoder.cflags | encoder.srgb))
+                return E_FAIL;
+        }
+
+        BlockCache* pCache = encoder.pCache;
+
+        XM_ALIGNED_DATA(16) XMVECTOR batch[NUM_PIXELS_PER_BLOCK * NUM_BLOCKS_PER_BATCH];
+        XM_ALIGNED_DATA(16) XMVECTOR hit[NUM_PIXELS_PER_BLOCK];
+        PackedVector::XMUBYTEN4 bytes[NUM_PIXELS_PER_BLOCK];
+        uint8_t* bdest[NUM_BLOCKS_PER_BATCH] = {};
+        CompressBlockInfo* binfo[NUM_BLOCKS_PER_BATCH] = {};
+        size_t bwidth[NUM_BLOCKS_PER_BATCH] = {};
+        BlockHash bkeys[NUM_BLOCKS_PER_BATCH] = {};
+        size_t nbatch = 0;
+        for (size_t bx = 0; bx < nBlocks; ++bx)
+        {
+            const size_t w = bx * 4;
+            const size_t pw = std::min<size_t>(4, width - w);
+            assert(pw > 0 && ph > 0);
 
-            const uint8_t *sptr = pSrc;
-            uint8_t* dptr = pDest;
-            const size_t ph = std::min<size_t>(4, image.height - h);
-            size_t w = 0;
-            for (size_t count = 0; (count < result.rowPitch) && (w < image.width); count += blocksize, w += 4)
+            const uint8_t *sptr = pSrc + w * encoder.sbpp;
+            uint8_t *dptr = pDest + bx * encoder.blocksize;
+
+            BlockHash key = {};
+            if (encoder.fromHalf)
             {
-                const size_t pw = std::min<size_t>(4, image.width - w);
-                assert(pw > 0 && ph > 0);
+                PackedVector::XMHALF4 block[NUM_PIXELS_PER_BLOCK];
+                LoadBlockHalf(block, sptr, rowPitch, pw, ph);
 
-                const ptrdiff_t bytesLeft = pEnd - sptr;
-                assert(bytesLeft > 0);
-                size_t bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft));
-                if (!LoadScanline(&temp[0], pw, sptr, bytesToRead, format))
-                    return E_FAIL;
+                if (pCache)
+                    key = HashBlock(block, sizeof(block));
 
-                if (ph > 1)
+                BLOCK_SOURCE source = BLOCK_CACHED;
+                if (!pCache || !pCache->Find(key, block, sizeof(block), dptr, encoder.blocksize))
                 {
-                    bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft) - rowPitch);
-                    if (!LoadScanline(&temp[4], pw, sptr + rowPitch, bytesToRead, format))
-                        return E_FAIL;
+                    EncodeBC6HFromHalf(cformat, dptr, block, encoder.errorTarget, bcflags);
+                    source = BLOCK_ENCODED;
 
-                    if (ph > 2)
-                    {
-                        bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft) - rowPitch * 2);
-                        if (!LoadScanline(&temp[8], pw, sptr + rowPitch * 2, bytesToRead, format))
-                            return E_FAIL;
+                    if (pCache)
+                        pCache->Insert(key, block, sizeof(block), dptr, encoder.blocksize);
+                }
 
-                        if (ph > 3)
-                        {
-                            bytesToRead = std::min<size_t>(rowPitch, static_cast<size_t>(bytesLeft) - rowPitch * 3);
-                            if (!LoadScanline(&temp[12], pw, sptr + rowPitch * 3, bytesToRead, format))
-                                return E_FAIL;
-                        }
+                if (pInfo || pCounts)
+                {
+                    XM_ALIGNED_DATA(16) XMVECTOR color[NUM_PIXELS_PER_BLOCK];
+                    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+                    {
+                        color[i] = PackedVector::XMLoadHalf4(&block[i]);
                     }
+                    RecordBlock(encoder, dptr, color, pw, ph, source, (pInfo) ? &pInfo[bx] : nullptr, pCounts);
                 }
+                continue;
+            }
 
-                if (pw != 4 || ph != 4)
+            const XMVECTOR* temp;
+            if (staged)
+            {
+                temp = &pStaging[bx * NUM_PIXELS_PER_BLOCK];
+            }
+            else
+            {
+                XMVECTOR* pColor = &batch[nbatch * NUM_PIXELS_PER_BLOCK];
+                LoadBlockBytes(bytes, image.format, sptr, rowPitch, pw, ph);
+                for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
                 {
-                    // Replicate pixels for partial block
-                    static const size_t uSrc[] = { 0, 0, 0, 1 };
+                    pColor[i] = PackedVector::XMLoadUByteN4(&bytes[i]);
+                }
+                temp = pColor;
+            }
 
-                    if (pw < 4)
-                    {
-                        for (size_t t = 0; t < ph && t < 4; ++t)
-                        {
-                            for (size_t s = pw; s < 4; ++s)
-                            {
-                            #pragma prefast(suppress: 26000, "PREFAST false positive")
-                                temp[(t << 2) | s] = temp[(t << 2) | uSrc[s]];
-                            }
-                        }
-                    }
+            if (encoder.solid && IsSolidBlock(temp, encoder.solidMask))
+            {
+                if (encoder.pfEncodeSolid)
+                    encoder.pfEncodeSolid(dptr, temp, bcflags);
+                else
+                    D3DXEncodeSolidBC1(dptr, temp, encoder.threshold, bcflags);
+
+                if (pInfo || pCounts)
+                    RecordBlock(encoder, dptr, temp, pw, ph, BLOCK_SOLID, (pInfo) ? &pInfo[bx] : nullptr, pCounts);
+                continue;
+            }
 
-                    if (ph < 4)
+            if (pCache)
+            {
+                // Solid blocks are already encoded from tables, so only the others are looked up
+                key = HashBlock(temp, sizeof(XMVECTOR) * NUM_PIXELS_PER_BLOCK);
+                if (pCache->Find(key, temp, sizeof(XMVECTOR) * NUM_PIXELS_PER_BLOCK, dptr, encoder.blocksize))
+                {
+                    if (rdo)
                     {
-                        for (size_t t = ph; t < 4; ++t)
+                        // Rate optimization looks back along the row, so blocks still waiting in the batch are
+                        // finished first. The batch encoder pads over the next slot, which may hold this block.
+                        if (nbatch > 0)
                         {
-                            for (size_t s = 0; s < 4; ++s)
-                            {
-                            #pragma prefast(suppress: 26000, "PREFAST false positive")
-                                temp[(t << 2) | s] = temp[(uSrc[t] << 2) | s];
-                            }
+                            memcpy(hit, temp, sizeof(hit));
+                            temp = hit;
+
+                            EncodeBatch(cformat, bdest, batch, nbatch, encoder.threshold, encoder.errorTarget, bcflags);
+                            FinishBatch(encoder, pDest, bkeys, bdest, binfo, bwidth, ph, batch, nbatch, pCounts);
+                            nbatch = 0;
                         }
+
+                        OptimizeBlockRate(cformat, dptr, temp, pDest, encoder.blocksize, encoder.rdoLambda);
                     }
+
+                    if (pInfo || pCounts)
+                        RecordBlock(encoder, dptr, temp, pw, ph, BLOCK_CACHED, (pInfo) ? &pInfo[bx] : nullptr, pCounts);
+                    continue;
                 }
+            }
+
+            if (!encoder.batched)
+            {
+                EncodeBlock(cformat, encoder.pfEncode, dptr, temp, encoder.fromBytes ? bytes : nullptr, encoder.errorTarget, bcflags);
 
-                ConvertScanline(temp, 16, result.format, format, cflags | srgb);
+                if (pCache)
+                    pCache->Insert(key, temp, sizeof(XMVECTOR) * NUM_PIXELS_PER_BLOCK, dptr, encoder.blocksize);
 
-                if (pfEncode)
-                    pfEncode(dptr, temp, bcflags);
-                else
-                    D3DXEncodeBC1(dptr, temp, threshold, bcflags);
+                if (rdo)
+                    OptimizeBlockRate(cformat, dptr, temp, pDest, encoder.blocksize, encoder.rdoLambda);
+
+                if (pInfo || pCounts)
+                    RecordBlock(encoder, dptr, temp, pw, ph, BLOCK_ENCODED, (pInfo) ? &pInfo[bx] : nullptr, pCounts);
+            }
+            else
+            {
+                // The batch encoder pads its input, so staged blocks are copied rather than encoded in place
+                if (temp != &batch[nbatch * NUM_PIXELS_PER_BLOCK])
+                {
+                    memcpy(&batch[nbatch * NUM_PIXELS_PER_BLOCK], temp, sizeof(XMVECTOR) * NUM_PIXELS_PER_BLOCK);
+                }
 
-                sptr += sbpp * 4;
-                dptr += blocksize;
+                bdest[nbatch] = dptr;
+                binfo[nbatch] = (pInfo) ? &pInfo[bx] : nullptr;
+                bwidth[nbatch] = pw;
+                bkeys[nbatch] = key;
+                if (++nbatch == NUM_BLOCKS_PER_BATCH)
+                {
+                    EncodeBatch(cformat, bdest, batch, nbatch, encoder.threshold, encoder.errorTarget, bcflags);
+                    FinishBatch(encoder, pDest, bkeys, bdest, binfo, bwidth, ph, batch, nbatch, pCounts);
+                    nbatch = 0;
+                }
             }
+        }
+
+        // Encode any remaining batched blocks at the end of the row
+        if (nbatch > 0)
+        {
+            EncodeBatch(cformat, bdest, batch, nbatch, encoder.threshold, encoder.errorTarget, bcflags);
+            FinishBatch(encoder, pDest, bkeys, bdest, binfo, bwidth, ph, batch, nbatch, pCounts);
+        }
 
-            pSrc += rowPitch * 4;
-            pDest += result.rowPitch;
+        if (encoder.pStats)
+        {
+            encoder.pStats->Add(image, counts, StatsCollector::Elapsed(start));
         }
 
         return S_OK;
@@ -206,13 +1515,19 @@ namespace
 
 
     //-------------------------------------------------------------------------------------
-#ifdef _OPENMP
-    HRESULT CompressBC_Parallel(
+    // Progress is reported in block rows, as it is by CompressBC_Parallel
+    //-------------------------------------------------------------------------------------
+    HRESULT CompressBC(
         const Image& image,
         const Image& result,
         uint32_t bcflags,
         TEX_FILTER_FLAGS srgb,
         float threshold,
+        float errorTarget,
+        float rdoLambda,
+        _In_opt_ BlockCache* pCache,
+        _In_opt_ StatsCollector* pStats,
+        _Out_writes_opt_(_Inexpressible_("block count")) CompressBlockInfo* pBlockInfo,
         const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
     {
         if (!image.pixels || !result.pixels)
@@ -221,156 +1536,290 @@ namespace
         assert(image.width == result.width);
         assert(image.height == result.height);
 
-        const DXGI_FORMAT format = image.format;
-        size_t sbpp = BitsPerPixel(format);
-        if (!sbpp)
-            return E_FAIL;
+        BCEncoder encoder;
+        HRESULT hr = DetermineEncoder(image.format, result.format, bcflags, srgb, threshold, errorTarget, rdoLambda, encoder);
+        if (FAILED(hr))
+            return hr;
 
-        if (sbpp < 8)
+        encoder.pCache = pCache;
+        encoder.pStats = pStats;
+
+        ScopedAlignedArrayXMVECTOR staging;
+        if (encoder.IsStaged())
         {
-            // We don't support compressing from monochrome (DXGI_FORMAT_R1_UNORM)
-            return HRESULT_E_NOT_SUPPORTED;
+            staging = make_AlignedArrayXMVECTOR(GetStagingSize(image.width));
+            if (!staging)
+                return E_OUTOFMEMORY;
         }
 
-        // Round to bytes
-        sbpp = (sbpp + 7) / 8;
+        const size_t nRows = (image.height + 3) / 4;
+        for (size_t h = 0; h < image.height; h += 4)
+        {
+            if (statusCallback)
+            {
+                if (!statusCallback(h / 4, nRows))
+                {
+                    return E_ABORT;
+                }
+            }
 
-        const uint8_t *pEnd = image.pixels + image.slicePitch;
+            const size_t nBlocks = (image.width + 3) / 4;
+            hr = CompressBlockRow(image, result, encoder, h / 4, 0, nBlocks, staging.get(),
+                (pBlockInfo) ? pBlockInfo + (h / 4) * nBlocks : nullptr);
+            if (FAILED(hr))
+                return hr;
+        }
 
-        // Determine BC format encoder
-        BC_ENCODE pfEncode;
-        size_t blocksize;
-        TEX_FILTER_FLAGS cflags;
-        if (!DetermineEncoderSettings(result.format, pfEncode, blocksize, cflags))
-            return HRESULT_E_NOT_SUPPORTED;
+        return S_OK;
+    }
 
-        // Refactored version of loop to support parallel independance
-        const size_t nBlocks = std::max<size_t>(1, (image.width + 3) / 4) * std::max<size_t>(1, (image.height + 3) / 4);
 
-        bool fail = false;
+    //-------------------------------------------------------------------------------------
+    // Compresses a whole set of images (every mip, array item and slice) as one flat pool of
+    // block rows, so the small tail mips do not each pay for a parallel region of their own
+    HRESULT CompressBC_Parallel(
+        _In_reads_(nimages) const Image* images,
+        _In_reads_(nimages) const Image* results,
+        size_t nimages,
+        uint32_t bcflags,
+        TEX_FILTER_FLAGS srgb,
+        float threshold,
+        float errorTarget,
+        float rdoLambda,
+        size_t maxThreads,
+        _In_opt_ BlockCache* pCache,
+        _In_opt_ StatsCollector* pStats,
+        _Out_writes_opt_(_Inexpressible_("block count")) CompressBlockInfo* pBlockInfo,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+    {
+        if (!images || !results || !nimages)
+            return E_INVALIDARG;
 
-        size_t progress = 0;
-        bool abort = false;
+        const DXGI_FORMAT format = images[0].format;
+        const DXGI_FORMAT cformat = results[0].format;
 
-        const size_t progressTotal = std::max<size_t>(1, (image.height + 3) / 4);
+        BCEncoder encoder;
+        HRESULT hr = DetermineEncoder(format, cformat, bcflags, srgb, threshold, errorTarget, rdoLambda, encoder);
+        if (FAILED(hr))
+            return hr;
 
-    #pragma omp parallel for shared(progress)
-        for (int nb = 0; nb < static_cast<int>(nBlocks); ++nb)
-        {
-        #pragma omp flush (abort)
-            if (abort)
-            {
-                // Short circuit the loop body if an abort is requested.
-                // OpenMP 2.0 does not support cancellation of a 'parallel for' loop.
-                continue;
-            }
+        encoder.pCache = pCache;
+        encoder.pStats = pStats;
 
-            const int nbWidth = std::max<int>(1, int((image.width + 3) / 4));
+        // rowStart[i] is the first block row of image i, and blockStart[i] its first block
+        std::unique_ptr<size_t[]> rowStart(new (std::nothrow) size_t[nimages + 1]);
+        std::unique_ptr<size_t[]> blockStart(new (std::nothrow) size_t[nimages]);
+        if (!rowStart || !blockStart)
+            return E_OUTOFMEMORY;
 
-            int y = nb / nbWidth;
-            const int x = (nb - (y*nbWidth)) * 4;
-            y *= 4;
+        size_t stagingSize = 0;
+        size_t nBlocks = 0;
+        rowStart[0] = 0;
+        for (size_t index = 0; index < nimages; ++index)
+        {
+            const Image& image = images[index];
+            const Image& result = results[index];
+            if (!image.pixels || !result.pixels)
+                return E_POINTER;
 
-            assert((x >= 0) && (x < int(image.width)));
-            assert((y >= 0) && (y < int(image.height)));
+            if (image.format != format || result.format != cformat)
+                return E_FAIL;
 
-            const size_t rowPitch = image.rowPitch;
-            const uint8_t *pSrc = image.pixels + (size_t(y)*rowPitch) + (size_t(x)*sbpp);
+            assert(image.width == result.width);
+            assert(image.height == result.height);
 
-            uint8_t *pDest = result.pixels + (size_t(nb)*blocksize);
+            rowStart[index + 1] = rowStart[index] + (image.height + 3) / 4;
+            blockStart[index] = nBlocks;
+            nBlocks += ((image.width + 3) / 4) * ((image.height + 3) / 4);
+            stagingSize = std::max(stagingSize, GetStagingSize(image.width));
+        }
 
-            const size_t ph = std::min<size_t>(4, image.height - size_t(y));
-            const size_t pw = std::min<size_t>(4, image.width - size_t(x));
-            assert(pw > 0 && ph > 0);
+        const size_t nRows = rowStart[nimages];
 
-            const ptrdiff_t bytesLeft = pEnd - pSrc;
-            assert(bytesLeft > 0);
-            size_t bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft));
+        std::atomic<bool> fail(false);
+        std::atomic<bool> oom(false);
 
-            XM_ALIGNED_DATA(16) XMVECTOR temp[16];
-            if (!LoadScanline(&temp[0], pw, pSrc, bytesToRead, format))
-                fail = true;
+        std::atomic<size_t> progress(0);
+        std::atomic<bool> abort(false);
 
-            if (ph > 1)
+        ParallelFor(nRows, maxThreads, [&](size_t nrow)
+        {
+            if (abort)
             {
-                bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft) - rowPitch);
-                if (!LoadScanline(&temp[4], pw, pSrc + rowPitch, bytesToRead, format))
-                    fail = true;
+                // Short circuit the work item if an abort is requested.
+                return;
+            }
 
-                if (ph > 2)
-                {
-                    bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft) - rowPitch * 2);
-                    if (!LoadScanline(&temp[8], pw, pSrc + rowPitch * 2, bytesToRead, format))
-                        fail = true;
+            const size_t* it = std::upper_bound(rowStart.get(), rowStart.get() + nimages + 1, nrow);
+            const size_t index = size_t(it - rowStart.get()) - 1;
 
-                    if (ph > 3)
-                    {
-                        bytesToRead = std::min<size_t>(rowPitch, size_t(bytesLeft) - rowPitch * 3);
-                        if (!LoadScanline(&temp[12], pw, pSrc + rowPitch * 3, bytesToRead, format))
-                            fail = true;
-                    }
+            // Report progress across the whole set, in block rows.
+            if (statusCallback)
+            {
+                if (!statusCallback(++progress, nRows))
+                {
+                    abort = true;
                 }
             }
 
-            if (pw != 4 || ph != 4)
+            XMVECTOR* pStaging = (encoder.IsStaged()) ? GetThreadStaging(stagingSize) : nullptr;
+
+            const size_t blockRow = nrow - rowStart[index];
+            const size_t nRowBlocks = (images[index].width + 3) / 4;
+            const HRESULT hrRow = CompressBlockRow(images[index], results[index], encoder, blockRow, 0, nRowBlocks, pStaging,
+                (pBlockInfo) ? pBlockInfo + blockStart[index] + blockRow * nRowBlocks : nullptr);
+            if (hrRow == E_OUTOFMEMORY)
+            {
+                oom = true;
+            }
+            else if (FAILED(hrRow))
             {
-                // Replicate pixels for partial block
-                static const size_t uSrc[] = { 0, 0, 0, 1 };
+                fail = true;
+            }
+        });
 
-                if (pw < 4)
-                {
-                    for (size_t t = 0; t < ph && t < 4; ++t)
-                    {
-                        for (size_t s = pw; s < 4; ++s)
-                        {
-                            temp[(t << 2) | s] = temp[(t << 2) | uSrc[s]];
-                        }
-                    }
-                }
+        if (abort)
+        {
+            return E_ABORT;
+        }
+        else if (oom)
+        {
+            return E_OUTOFMEMORY;
+        }
+        else
+        {
+            return (fail) ? E_FAIL : S_OK;
+        }
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // A run of blocks in one block row of a region being compressed
+    struct BlockSpan
+    {
+        size_t blockRow;
+        size_t firstBlock;
+        size_t nBlocks;
+    };
 
-                if (ph < 4)
+    // Number of block rows touched by a rectangle
+    inline size_t CountBlockRows(const Rect& rect) noexcept
+    {
+        return ((rect.y + rect.h + 3) / 4) - (rect.y / 4);
+    }
+
+    // Covers the rectangles with spans of whole blocks, merged so overlapping rectangles do not encode a block twice.
+    // maxSpans is the sum of CountBlockRows() over the rectangles; returns how many spans are used.
+    size_t GetRegionSpans(
+        _In_reads_(nrects) const Rect* rects,
+        size_t nrects,
+        _Out_writes_to_(maxSpans, return) BlockSpan* pSpans,
+        size_t maxSpans)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < nrects; ++i)
+        {
+            const Rect& rect = rects[i];
+            const size_t nRows = CountBlockRows(rect);
+
+            const size_t firstBlock = rect.x / 4;
+            const size_t nBlocks = ((rect.x + rect.w + 3) / 4) - firstBlock;
+            for (size_t by = 0; by < nRows; ++by)
+            {
+                assert(count < maxSpans);
+                pSpans[count++] = { rect.y / 4 + by, firstBlock, nBlocks };
+            }
+        }
+
+        std::sort(pSpans, pSpans + count, [](const BlockSpan& a, const BlockSpan& b) noexcept
+            {
+                return (a.blockRow < b.blockRow) || (a.blockRow == b.blockRow && a.firstBlock < b.firstBlock);
+            });
+
+        size_t nspans = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const BlockSpan& span = pSpans[i];
+            if (nspans > 0)
+            {
+                BlockSpan& last = pSpans[nspans - 1];
+                if (last.blockRow == span.blockRow && span.firstBlock <= last.firstBlock + last.nBlocks)
                 {
-                    for (size_t t = ph; t < 4; ++t)
-                    {
-                        for (size_t s = 0; s < 4; ++s)
-                        {
-                            temp[(t << 2) | s] = temp[(uSrc[t] << 2) | s];
-                        }
-                    }
+                    last.nBlocks = std::max(last.nBlocks, span.firstBlock + span.nBlocks - last.firstBlock);
+                    continue;
                 }
             }
 
-            ConvertScanline(temp, 16, result.format, format, cflags | srgb);
+            pSpans[nspans++] = span;
+        }
 
-            if (pfEncode)
-                pfEncode(pDest, temp, bcflags);
-            else
-                D3DXEncodeBC1(pDest, temp, threshold, bcflags);
+        return nspans;
+    }
+
+    HRESULT CompressSpans(
+        const Image& image,
+        const Image& result,
+        const BCEncoder& encoder,
+        _In_reads_(nspans) const BlockSpan* pSpans,
+        size_t nspans,
+        bool parallel,
+        size_t maxThreads,
+        _Out_writes_opt_(_Inexpressible_("block count")) CompressBlockInfo* pBlockInfo) noexcept
+    {
+        const size_t nRowBlocks = (image.width + 3) / 4;
 
-            // Report progress when a new row is reached.
-            if (x == 0 && statusCallback)
+        if (!parallel)
+        {
+            ScopedAlignedArrayXMVECTOR staging;
+            if (encoder.IsStaged())
             {
-            #pragma omp atomic
-                progress += 4;
+                staging = make_AlignedArrayXMVECTOR(GetStagingSize(image.width));
+                if (!staging)
+                    return E_OUTOFMEMORY;
+            }
 
-                if (!statusCallback(progress, progressTotal))
-                {
-                    abort = true;
-                #pragma omp flush (abort)
-                }
+            for (size_t i = 0; i < nspans; ++i)
+            {
+                const BlockSpan& span = pSpans[i];
+                const HRESULT hr = CompressBlockRow(image, result, encoder, span.blockRow, span.firstBlock, span.nBlocks, staging.get(),
+                    (pBlockInfo) ? pBlockInfo + span.blockRow * nRowBlocks + span.firstBlock : nullptr);
+                if (FAILED(hr))
+                    return hr;
             }
+
+            return S_OK;
         }
 
-        if (abort)
+        // Spans never overlap and rate optimization only looks back within a span, so each one is an independent work item
+        std::atomic<bool> fail(false);
+        std::atomic<bool> oom(false);
+
+        ParallelFor(nspans, maxThreads, [&](size_t i)
         {
-            return E_ABORT;
+            XMVECTOR* pStaging = (encoder.IsStaged()) ? GetThreadStaging(GetStagingSize(image.width)) : nullptr;
+
+            const BlockSpan& span = pSpans[i];
+            const HRESULT hr = CompressBlockRow(image, result, encoder, span.blockRow, span.firstBlock, span.nBlocks, pStaging,
+                (pBlockInfo) ? pBlockInfo + span.blockRow * nRowBlocks + span.firstBlock : nullptr);
+            if (hr == E_OUTOFMEMORY)
+            {
+                oom = true;
+            }
+            else if (FAILED(hr))
+            {
+                fail = true;
+            }
+        });
+
+        if (oom)
+        {
+            return E_OUTOFMEMORY;
         }
         else
         {
             return (fail) ? E_FAIL : S_OK;
         }
     }
-#endif // _OPENMP
 
 
     //-------------------------------------------------------------------------------------
@@ -408,21 +1857,109 @@ namespace
         case DXGI_FORMAT_BC5_SNORM:
             return DXGI_FORMAT_R8G8_SNORM;
 
-        case DXGI_FORMAT_BC6H_TYPELESS:
+        case DXGI_FORMAT_BC6H_TYPELESS:
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+            // We could use DXGI_FORMAT_R32G32B32_FLOAT here since BC6H is always Alpha 1.0,
+            // but this format is more supported by viewers
+            return DXGI_FORMAT_R32G32B32A32_FLOAT;
+
+        default:
+            return DXGI_FORMAT_UNKNOWN;
+        }
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Block formats that decode straight to the destination pixels, bypassing XMVECTOR.
+    // BC6H decodes to half floats, which widen exactly to DXGI_FORMAT_R32G32B32A32_FLOAT.
+    inline bool IsDecodedDirect(_In_ DXGI_FORMAT cformat, _In_ DXGI_FORMAT format) noexcept
+    {
+        switch (cformat)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC7_UNORM:
+            return (format == DXGI_FORMAT_R8G8B8A8_UNORM);
+
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return (format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+
+        case DXGI_FORMAT_BC4_UNORM:
+            return (format == DXGI_FORMAT_R8_UNORM);
+
+        case DXGI_FORMAT_BC5_UNORM:
+            return (format == DXGI_FORMAT_R8G8_UNORM);
+
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+            return (format == DXGI_FORMAT_R16G16B16A16_FLOAT || format == DXGI_FORMAT_R32G32B32A32_FLOAT);
+
+        default:
+            return false;
+        }
+    }
+
+    inline void DecodeDirect(
+        _In_ DXGI_FORMAT cformat,
+        _Out_ void* pDest,
+        _In_ const uint8_t* pBC,
+        size_t count) noexcept
+    {
+        switch (cformat)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+            D3DXDecodeBC1ToRGBA8(static_cast<PackedVector::XMUBYTEN4*>(pDest), pBC, count);
+            break;
+
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+            D3DXDecodeBC2ToRGBA8(static_cast<PackedVector::XMUBYTEN4*>(pDest), pBC, count);
+            break;
+
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+            D3DXDecodeBC3ToRGBA8(static_cast<PackedVector::XMUBYTEN4*>(pDest), pBC, count);
+            break;
+
+        case DXGI_FORMAT_BC4_UNORM:
+            D3DXDecodeBC4UToR8(static_cast<uint8_t*>(pDest), pBC, count);
+            break;
+
+        case DXGI_FORMAT_BC5_UNORM:
+            D3DXDecodeBC5UToR8G8(static_cast<PackedVector::XMUBYTEN2*>(pDest), pBC, count);
+            break;
+
         case DXGI_FORMAT_BC6H_UF16:
+            D3DXDecodeBC6HUToHalf(static_cast<PackedVector::XMHALF4*>(pDest), pBC, count);
+            break;
+
         case DXGI_FORMAT_BC6H_SF16:
-            // We could use DXGI_FORMAT_R32G32B32_FLOAT here since BC6H is always Alpha 1.0,
-            // but this format is more supported by viewers
-            return DXGI_FORMAT_R32G32B32A32_FLOAT;
+            D3DXDecodeBC6HSToHalf(static_cast<PackedVector::XMHALF4*>(pDest), pBC, count);
+            break;
 
         default:
-            return DXGI_FORMAT_UNKNOWN;
+            D3DXDecodeBC7ToRGBA8(static_cast<PackedVector::XMUBYTEN4*>(pDest), pBC, count);
+            break;
         }
     }
 
+    // How the blocks of a compressed image are decoded into the destination image
+    struct BCDecoder
+    {
+        DXGI_FORMAT cformat;
+        BC_DECODE pfDecode;
+        size_t sbpp;
+        size_t dbpp;
+        bool direct;
+    };
 
-    //-------------------------------------------------------------------------------------
-    HRESULT DecompressBC(_In_ const Image& cImage, _In_ const Image& result) noexcept
+    HRESULT DetermineDecoder(_In_ const Image& cImage, _In_ const Image& result, _Out_ BCDecoder& decoder) noexcept
     {
         if (!cImage.pixels || !result.pixels)
             return E_POINTER;
@@ -442,11 +1979,7 @@ namespace
         }
 
         // Round to bytes
-        dbpp = (dbpp + 7) / 8;
-
-        uint8_t *pDest = result.pixels;
-        if (!pDest)
-            return E_POINTER;
+        decoder.dbpp = (dbpp + 7) / 8;
 
         // Promote "typeless" BC formats
         DXGI_FORMAT cformat;
@@ -485,54 +2018,187 @@ namespace
             return HRESULT_E_NOT_SUPPORTED;
         }
 
-        XM_ALIGNED_DATA(16) XMVECTOR temp[16];
-        const uint8_t *pSrc = cImage.pixels;
+        decoder.cformat = cformat;
+        decoder.pfDecode = pfDecode;
+        decoder.sbpp = sbpp;
+        decoder.direct = IsDecodedDirect(cformat, format);
+
+        return S_OK;
+    }
+
+    // Decodes one row of blocks. Rows are independent, so any number of them can be decoded at once.
+    HRESULT DecompressBlockRow(
+        _In_ const Image& cImage,
+        _In_ const Image& result,
+        _In_ const BCDecoder& decoder,
+        size_t blockRow) noexcept
+    {
+        const size_t h = blockRow * 4;
+        assert(h < cImage.height);
+
+        const DXGI_FORMAT format = result.format;
+        const size_t sbpp = decoder.sbpp;
+        const size_t dbpp = decoder.dbpp;
+        const size_t ph = std::min<size_t>(4, cImage.height - h);
+        const uint8_t *pSrc = cImage.pixels + cImage.rowPitch * blockRow;
+        uint8_t *pDest = result.pixels + result.rowPitch * h;
         const size_t rowPitch = result.rowPitch;
-        for (size_t h = 0; h < cImage.height; h += 4)
+
+        if (decoder.direct)
         {
-            const uint8_t *sptr = pSrc;
-            uint8_t* dptr = pDest;
-            const size_t ph = std::min<size_t>(4, cImage.height - h);
-            size_t w = 0;
-            for (size_t count = 0; (count < cImage.rowPitch) && (w < cImage.width); count += sbpp, w += 4)
+            // Decode NUM_BLOCKS_PER_BATCH blocks at a time and copy their rows into place
+            const bool widen = (format == DXGI_FORMAT_R32G32B32A32_FLOAT);
+            const size_t bpp = widen ? sizeof(PackedVector::XMHALF4) : dbpp;
+
+            XM_ALIGNED_DATA(16) uint8_t temp[NUM_PIXELS_PER_BLOCK * NUM_BLOCKS_PER_BATCH * sizeof(PackedVector::XMHALF4)];
+
+            const size_t nBlocks = std::min<size_t>((cImage.rowPitch + sbpp - 1) / sbpp, (cImage.width + 3) / 4);
+            for (size_t bx = 0; bx < nBlocks; bx += NUM_BLOCKS_PER_BATCH)
             {
-                pfDecode(temp, sptr);
-                ConvertScanline(temp, 16, format, cformat, TEX_FILTER_DEFAULT);
+                const size_t count = std::min<size_t>(NUM_BLOCKS_PER_BATCH, nBlocks - bx);
+                DecodeDirect(decoder.cformat, temp, pSrc + bx * sbpp, count);
+
+                for (size_t j = 0; j < count; ++j)
+                {
+                    const size_t w = (bx + j) * 4;
+                    const size_t pw = std::min<size_t>(4, cImage.width - w);
+                    const uint8_t *sptr = &temp[j * NUM_PIXELS_PER_BLOCK * bpp];
+                    for (size_t t = 0; t < ph; ++t)
+                    {
+                        if (widen)
+                        {
+                            PackedVector::XMConvertHalfToFloatStream(
+                                reinterpret_cast<float*>(pDest + rowPitch * t) + w * 4, sizeof(float),
+                                reinterpret_cast<const PackedVector::HALF*>(sptr + t * 4 * bpp), sizeof(PackedVector::HALF),
+                                pw * 4);
+                        }
+                        else
+                        {
+                            memcpy(pDest + rowPitch * t + w * bpp, sptr + t * 4 * bpp, pw * bpp);
+                        }
+                    }
+                }
+            }
+
+            return S_OK;
+        }
+
+        XM_ALIGNED_DATA(16) XMVECTOR temp[16];
+        const uint8_t *sptr = pSrc;
+        uint8_t* dptr = pDest;
+        size_t w = 0;
+        for (size_t count = 0; (count < cImage.rowPitch) && (w < cImage.width); count += sbpp, w += 4)
+        {
+            decoder.pfDecode(temp, sptr);
+            ConvertScanline(temp, 16, format, decoder.cformat, TEX_FILTER_DEFAULT);
 
-                const size_t pw = std::min<size_t>(4, cImage.width - w);
-                assert(pw > 0 && ph > 0);
+            const size_t pw = std::min<size_t>(4, cImage.width - w);
+            assert(pw > 0 && ph > 0);
 
-                if (!StoreScanline(dptr, rowPitch, format, &temp[0], pw))
+            if (!StoreScanline(dptr, rowPitch, format, &temp[0], pw))
+                return E_FAIL;
+
+            if (ph > 1)
+            {
+                if (!StoreScanline(dptr + rowPitch, rowPitch, format, &temp[4], pw))
                     return E_FAIL;
 
-                if (ph > 1)
+                if (ph > 2)
                 {
-                    if (!StoreScanline(dptr + rowPitch, rowPitch, format, &temp[4], pw))
+                    if (!StoreScanline(dptr + rowPitch * 2, rowPitch, format, &temp[8], pw))
                         return E_FAIL;
 
-                    if (ph > 2)
+                    if (ph > 3)
                     {
-                        if (!StoreScanline(dptr + rowPitch * 2, rowPitch, format, &temp[8], pw))
+                        if (!StoreScanline(dptr + rowPitch * 3, rowPitch, format, &temp[12], pw))
                             return E_FAIL;
-
-                        if (ph > 3)
-                        {
-                            if (!StoreScanline(dptr + rowPitch * 3, rowPitch, format, &temp[12], pw))
-                                return E_FAIL;
-                        }
                     }
                 }
-
-                sptr += sbpp;
-                dptr += dbpp * 4;
             }
 
-            pSrc += cImage.rowPitch;
-            pDest += rowPitch * 4;
+            sptr += sbpp;
+            dptr += dbpp * 4;
+        }
+
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    HRESULT DecompressBC(_In_ const Image& cImage, _In_ const Image& result) noexcept
+    {
+        BCDecoder decoder;
+        HRESULT hr = DetermineDecoder(cImage, result, decoder);
+        if (FAILED(hr))
+            return hr;
+
+        const size_t nRows = (cImage.height + 3) / 4;
+        for (size_t blockRow = 0; blockRow < nRows; ++blockRow)
+        {
+            hr = DecompressBlockRow(cImage, result, decoder, blockRow);
+            if (FAILED(hr))
+                return hr;
         }
 
         return S_OK;
     }
+
+    // Image sets with at least this many blocks are split across threads when the caller allows it
+    constexpr size_t PARALLEL_DECOMPRESS_BLOCKS = 4096;
+
+    inline size_t GetDecompressThreads(const DecompressOptions& options) noexcept
+    {
+        return (options.flags & TEX_DECOMPRESS_PARALLEL) ? options.maxThreads : 1;
+    }
+
+    inline size_t CountBlocks(_In_reads_(nimages) const Image* cImages, size_t nimages) noexcept
+    {
+        size_t nBlocks = 0;
+        for (size_t index = 0; index < nimages; ++index)
+        {
+            nBlocks += ((cImages[index].width + 3) / 4) * ((cImages[index].height + 3) / 4);
+        }
+        return nBlocks;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Every block row of every image is one task, so the small mips of a chain are decoded
+    // alongside the large ones rather than each paying for a parallel region of its own
+    HRESULT DecompressBC_Parallel(
+        _In_reads_(nimages) const Image* cImages,
+        _In_reads_(nimages) const Image* results,
+        size_t nimages,
+        size_t maxThreads) noexcept
+    {
+        std::unique_ptr<BCDecoder[]> decoders(new (std::nothrow) BCDecoder[nimages]);
+        std::unique_ptr<size_t[]> rowStart(new (std::nothrow) size_t[nimages + 1]);
+        if (!decoders || !rowStart)
+            return E_OUTOFMEMORY;
+
+        rowStart[0] = 0;
+        for (size_t index = 0; index < nimages; ++index)
+        {
+            const HRESULT hr = DetermineDecoder(cImages[index], results[index], decoders[index]);
+            if (FAILED(hr))
+                return hr;
+
+            rowStart[index + 1] = rowStart[index] + (cImages[index].height + 3) / 4;
+        }
+
+        const size_t nRows = rowStart[nimages];
+
+        std::atomic<bool> fail(false);
+
+        ParallelFor(nRows, maxThreads, [&](size_t nrow)
+        {
+            const size_t* it = std::upper_bound(rowStart.get(), rowStart.get() + nimages + 1, nrow);
+            const size_t index = size_t(it - rowStart.get()) - 1;
+
+            if (FAILED(DecompressBlockRow(cImages[index], results[index], decoders[index], nrow - rowStart[index])))
+                fail = true;
+        });
+
+        return (fail) ? E_FAIL : S_OK;
+    }
 }
 
 //-------------------------------------------------------------------------------------
@@ -671,6 +2337,12 @@ HRESULT DirectX::CompressEx(
     if (IsCompressed(srcImage.format) || !IsCompressed(format) || !IsValid(srcImage.format))
         return E_INVALIDARG;
 
+    if ((options.flags & TEX_COMPRESS_EFFORT_FAST) && (options.flags & TEX_COMPRESS_EFFORT_BEST))
+        return E_INVALIDARG;
+
+    if (!(options.errorTarget >= 0.f) || !(options.rdoLambda >= 0.f))
+        return E_INVALIDARG;
+
     if (IsTypeless(format)
         || IsTypeless(srcImage.format) || IsPlanar(srcImage.format) || IsPalettized(srcImage.format))
         return HRESULT_E_NOT_SUPPORTED;
@@ -687,27 +2359,48 @@ HRESULT DirectX::CompressEx(
         return E_POINTER;
     }
 
+    // Progress is reported in block rows
+    const size_t nRows = (img->height + 3) / 4;
+
     if (statusCallback)
     {
-        if (!statusCallback(0, img->height))
+        if (!statusCallback(0, nRows))
         {
             image.Release();
             return E_ABORT;
         }
     }
 
+    std::unique_ptr<BlockCache> cache;
+    if (options.flags & TEX_COMPRESS_DEDUPLICATE)
+    {
+        cache.reset(new (std::nothrow) BlockCache);
+        if (!cache)
+        {
+            image.Release();
+            return E_OUTOFMEMORY;
+        }
+    }
+
+    std::unique_ptr<StatsCollector> stats;
+    if (options.stats)
+    {
+        stats.reset(new (std::nothrow) StatsCollector(*options.stats, &srcImage, 1));
+        if (!stats)
+        {
+            image.Release();
+            return E_OUTOFMEMORY;
+        }
+    }
+
     // Compress single image
     if (options.flags & TEX_COMPRESS_PARALLEL)
     {
-    #ifndef _OPENMP
-        hr = E_NOTIMPL;
-    #else
-        hr = CompressBC_Parallel(srcImage, *img, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, statusCallback);
-    #endif // _OPENMP
+        hr = CompressBC_Parallel(&srcImage, img, 1, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, options.errorTarget, options.rdoLambda, options.maxThreads, cache.get(), stats.get(), options.blockInfo, statusCallback);
     }
     else
     {
-        hr = CompressBC(srcImage, *img, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, statusCallback);
+        hr = CompressBC(srcImage, *img, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, options.errorTarget, options.rdoLambda, cache.get(), stats.get(), options.blockInfo, statusCallback);
     }
 
     if (FAILED(hr))
@@ -718,13 +2411,18 @@ HRESULT DirectX::CompressEx(
 
     if (statusCallback)
     {
-        if (!statusCallback(img->height, img->height))
+        if (!statusCallback(nRows, nRows))
         {
             image.Release();
             return E_ABORT;
         }
     }
 
+    if (stats)
+    {
+        stats->Finish();
+    }
+
     return S_OK;
 }
 
@@ -744,6 +2442,12 @@ HRESULT DirectX::CompressEx(
     if (IsCompressed(metadata.format) || !IsCompressed(format))
         return E_INVALIDARG;
 
+    if ((options.flags & TEX_COMPRESS_EFFORT_FAST) && (options.flags & TEX_COMPRESS_EFFORT_BEST))
+        return E_INVALIDARG;
+
+    if (!(options.errorTarget >= 0.f) || !(options.rdoLambda >= 0.f))
+        return E_INVALIDARG;
+
     if (IsTypeless(format)
         || IsTypeless(metadata.format) || IsPlanar(metadata.format) || IsPalettized(metadata.format))
         return HRESULT_E_NOT_SUPPORTED;
@@ -782,15 +2486,8 @@ HRESULT DirectX::CompressEx(
         return E_POINTER;
     }
 
-    if (statusCallback)
-    {
-        if (!statusCallback(0, nimages))
-        {
-            cImages.Release();
-            return E_ABORT;
-        }
-    }
-
+    // Progress is reported in block rows, summed over all the images
+    size_t nRows = 0;
     for (size_t index = 0; index < nimages; ++index)
     {
         assert(dest[index].format == format);
@@ -803,44 +2500,206 @@ HRESULT DirectX::CompressEx(
             return E_FAIL;
         }
 
-        if (options.flags & TEX_COMPRESS_PARALLEL)
+        nRows += (src.height + 3) / 4;
+    }
+
+    if (statusCallback)
+    {
+        if (!statusCallback(0, nRows))
+        {
+            cImages.Release();
+            return E_ABORT;
+        }
+    }
+
+    // A single cache lets blocks repeated across mips, array items and slices be encoded once
+    std::unique_ptr<BlockCache> cache;
+    if (options.flags & TEX_COMPRESS_DEDUPLICATE)
+    {
+        cache.reset(new (std::nothrow) BlockCache);
+        if (!cache)
         {
-        #ifndef _OPENMP
-            hr = E_NOTIMPL;
-        #else
-            hr = CompressBC_Parallel(src, dest[index], GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, nullptr);
-        #endif // _OPENMP
+            cImages.Release();
+            return E_OUTOFMEMORY;
         }
-        else
+    }
+
+    std::unique_ptr<StatsCollector> stats;
+    if (options.stats)
+    {
+        stats.reset(new (std::nothrow) StatsCollector(*options.stats, srcImages, nimages));
+        if (!stats)
         {
-            hr = CompressBC(src, dest[index], GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, nullptr);
+            cImages.Release();
+            return E_OUTOFMEMORY;
         }
+    }
+
+    if (options.flags & TEX_COMPRESS_PARALLEL)
+    {
+        // The whole chain is one pool of work, and the callback reports progress across all of it
+        hr = CompressBC_Parallel(srcImages, dest, nimages, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, options.errorTarget, options.rdoLambda, options.maxThreads, cache.get(), stats.get(), options.blockInfo, statusCallback);
 
         if (FAILED(hr))
         {
             cImages.Release();
             return hr;
         }
-
-        if (statusCallback)
+    }
+    else
+    {
+        CompressBlockInfo* pBlockInfo = options.blockInfo;
+        size_t rowsDone = 0;
+        for (size_t index = 0; index < nimages; ++index)
         {
-            if (!statusCallback(index, nimages))
+            std::function<bool __cdecl(size_t, size_t)> imageCallback;
+            if (statusCallback)
+            {
+                imageCallback = [&](size_t done, size_t) { return statusCallback(rowsDone + done, nRows); };
+            }
+
+            hr = CompressBC(srcImages[index], dest[index], GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, options.errorTarget, options.rdoLambda, cache.get(), stats.get(), pBlockInfo, imageCallback);
+            if (FAILED(hr))
             {
                 cImages.Release();
-                return E_ABORT;
+                return hr;
             }
+
+            if (pBlockInfo)
+            {
+                pBlockInfo += ((dest[index].width + 3) / 4) * ((dest[index].height + 3) / 4);
+            }
+
+            rowsDone += (dest[index].height + 3) / 4;
         }
     }
 
     if (statusCallback)
     {
-        if (!statusCallback(nimages, nimages))
+        if (!statusCallback(nRows, nRows))
         {
             cImages.Release();
             return E_ABORT;
         }
     }
 
+    if (stats)
+    {
+        stats->Finish();
+    }
+
+    return S_OK;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Region compression
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::CompressRegion(
+    const Image& srcImage,
+    const Rect& rect,
+    const CompressOptions& options,
+    const Image& cImage) noexcept
+{
+    return CompressRegion(srcImage, &rect, 1, options, cImage);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::CompressRegion(
+    const Image& srcImage,
+    const Rect* rects,
+    size_t nrects,
+    const CompressOptions& options,
+    const Image& cImage) noexcept
+{
+    if (!rects || !nrects)
+        return E_INVALIDARG;
+
+    if (!srcImage.pixels || !cImage.pixels)
+        return E_POINTER;
+
+    if (IsCompressed(srcImage.format) || !IsCompressed(cImage.format) || !IsValid(srcImage.format))
+        return E_INVALIDARG;
+
+    if ((options.flags & TEX_COMPRESS_EFFORT_FAST) && (options.flags & TEX_COMPRESS_EFFORT_BEST))
+        return E_INVALIDARG;
+
+    if (!(options.errorTarget >= 0.f) || !(options.rdoLambda >= 0.f))
+        return E_INVALIDARG;
+
+    if (IsTypeless(cImage.format)
+        || IsTypeless(srcImage.format) || IsPlanar(srcImage.format) || IsPalettized(srcImage.format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    if (srcImage.width != cImage.width || srcImage.height != cImage.height)
+        return E_INVALIDARG;
+
+    // The blocks are written in place, so cImage must be laid out exactly as ComputePitch describes
+    size_t rowPitch, slicePitch;
+    HRESULT hr = ComputePitch(cImage.format, cImage.width, cImage.height, rowPitch, slicePitch, CP_FLAGS_NONE);
+    if (FAILED(hr))
+        return hr;
+
+    if (cImage.rowPitch != rowPitch || cImage.slicePitch != slicePitch)
+        return E_INVALIDARG;
+
+    uint64_t totalRows = 0;
+    for (size_t i = 0; i < nrects; ++i)
+    {
+        const Rect& rect = rects[i];
+        // Written so that huge offsets or sizes cannot wrap around
+        if (!rect.w || !rect.h
+            || (rect.x >= srcImage.width) || (rect.w > srcImage.width - rect.x)
+            || (rect.y >= srcImage.height) || (rect.h > srcImage.height - rect.y))
+            return E_INVALIDARG;
+
+        totalRows += CountBlockRows(rect);
+    }
+
+    if (totalRows > SIZE_MAX / sizeof(BlockSpan))
+        return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+    std::unique_ptr<BlockSpan[]> spans(new (std::nothrow) BlockSpan[static_cast<size_t>(totalRows)]);
+    if (!spans)
+        return E_OUTOFMEMORY;
+
+    const size_t nspans = GetRegionSpans(rects, nrects, spans.get(), static_cast<size_t>(totalRows));
+
+    BCEncoder encoder;
+    hr = DetermineEncoder(srcImage.format, cImage.format, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, options.errorTarget, options.rdoLambda, encoder);
+    if (FAILED(hr))
+        return hr;
+
+    std::unique_ptr<BlockCache> cache;
+    if (options.flags & TEX_COMPRESS_DEDUPLICATE)
+    {
+        cache.reset(new (std::nothrow) BlockCache);
+        if (!cache)
+            return E_OUTOFMEMORY;
+
+        encoder.pCache = cache.get();
+    }
+
+    std::unique_ptr<StatsCollector> stats;
+    if (options.stats)
+    {
+        stats.reset(new (std::nothrow) StatsCollector(*options.stats, &srcImage, 1));
+        if (!stats)
+            return E_OUTOFMEMORY;
+
+        encoder.pStats = stats.get();
+    }
+
+    hr = CompressSpans(srcImage, cImage, encoder, spans.get(), nspans, (options.flags & TEX_COMPRESS_PARALLEL) != 0, options.maxThreads, options.blockInfo);
+    if (FAILED(hr))
+        return hr;
+
+    if (stats)
+    {
+        stats->Finish();
+    }
+
     return S_OK;
 }
 
@@ -853,6 +2712,29 @@ HRESULT DirectX::Decompress(
     const Image& cImage,
     DXGI_FORMAT format,
     ScratchImage& image) noexcept
+{
+    const DecompressOptions options = {};
+    return DecompressEx(cImage, format, options, image);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::Decompress(
+    const Image* cImages,
+    size_t nimages,
+    const TexMetadata& metadata,
+    DXGI_FORMAT format,
+    ScratchImage& images) noexcept
+{
+    const DecompressOptions options = {};
+    return DecompressEx(cImages, nimages, metadata, format, options, images);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::DecompressEx(
+    const Image& cImage,
+    DXGI_FORMAT format,
+    const DecompressOptions& options,
+    ScratchImage& image) noexcept
 {
     if (!IsCompressed(cImage.format) || IsCompressed(format))
         return E_INVALIDARG;
@@ -889,7 +2771,15 @@ HRESULT DirectX::Decompress(
     }
 
     // Decompress single image
-    hr = DecompressBC(cImage, *img);
+    const size_t maxThreads = GetDecompressThreads(options);
+    if (maxThreads != 1 && CountBlocks(&cImage, 1) >= PARALLEL_DECOMPRESS_BLOCKS)
+    {
+        hr = DecompressBC_Parallel(&cImage, img, 1, maxThreads);
+    }
+    else
+    {
+        hr = DecompressBC(cImage, *img);
+    }
     if (FAILED(hr))
         image.Release();
 
@@ -897,11 +2787,12 @@ HRESULT DirectX::Decompress(
 }
 
 _Use_decl_annotations_
-HRESULT DirectX::Decompress(
+HRESULT DirectX::DecompressEx(
     const Image* cImages,
     size_t nimages,
     const TexMetadata& metadata,
     DXGI_FORMAT format,
+    const DecompressOptions& options,
     ScratchImage& images) noexcept
 {
     if (!cImages || !nimages)
@@ -966,8 +2857,25 @@ HRESULT DirectX::Decompress(
             images.Release();
             return E_FAIL;
         }
+    }
+
+    const size_t maxThreads = GetDecompressThreads(options);
+    if (maxThreads != 1 && CountBlocks(cImages, nimages) >= PARALLEL_DECOMPRESS_BLOCKS)
+    {
+        // Decompress the whole set at once so small mips and slices share the workers
+        hr = DecompressBC_Parallel(cImages, dest, nimages, maxThreads);
+        if (FAILED(hr))
+        {
+            images.Release();
+            return hr;
+        }
+
+        return S_OK;
+    }
 
-        hr = DecompressBC(src, dest[index]);
+    for (size_t index = 0; index < nimages; ++index)
+    {
+        hr = DecompressBC(cImages[index], dest[index]);
         if (FAILED(hr))
         {
             images.Release();
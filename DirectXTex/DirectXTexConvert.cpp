@@ -11,6 +11,16 @@
 
 #include "DirectXTexP.h"
 
+#if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_F16C_INTRINSICS_)
+#define USE_F16C_DISPATCH
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#endif
+
 using namespace DirectX;
 using namespace DirectX::Internal;
 using namespace DirectX::PackedVector;
@@ -195,6 +205,667 @@ namespace
     const XMVECTORF32 g_HalfMin = { { { -65504.f, -65504.f, -65504.f, -65504.f } } };
     const XMVECTORF32 g_HalfMax = { { { 65504.f, 65504.f, 65504.f, 65504.f } } };
     const XMVECTORF32 g_8BitBias = { { { 0.5f / 255.f, 0.5f / 255.f, 0.5f / 255.f, 0.5f / 255.f } } };
+
+    //-------------------------------------------------------------------------------------
+    // sRGB -> Linear RGB for 8-bit data is a lookup, built once from the same math as
+    // LoadScanline + XMColorSRGBToRGB so results are unchanged
+    //-------------------------------------------------------------------------------------
+    struct SRGBTable
+    {
+        float linear[256];
+        float unorm[256];
+    };
+
+    SRGBTable BuildSRGBTable() noexcept
+    {
+        SRGBTable table = {};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            const auto c = static_cast<uint8_t>(i);
+            const XMUBYTEN4 pixel(c, c, c, c);
+            const XMVECTOR v = XMLoadUByteN4(&pixel);
+            table.linear[i] = XMVectorGetX(XMColorSRGBToRGB(v));
+            table.unorm[i] = XMVectorGetW(v);
+        }
+        return table;
+    }
+
+    const SRGBTable& GetSRGBTable() noexcept
+    {
+        static const SRGBTable s_table = BuildSRGBTable();
+        return s_table;
+    }
+
+    bool LoadScanlineSRGB8(
+        _Out_writes_(count) XMVECTOR* pDestination,
+        size_t count,
+        _In_reads_bytes_(size) const void* pSource,
+        size_t size,
+        DXGI_FORMAT format) noexcept
+    {
+        if (size < sizeof(uint32_t))
+            return false;
+
+        const SRGBTable& table = GetSRGBTable();
+
+        const size_t pixels = std::min(count, size / sizeof(uint32_t));
+        const uint32_t * __restrict sPtr = static_cast<const uint32_t*>(pSource);
+        XMVECTOR* __restrict dPtr = pDestination;
+
+        switch (static_cast<int>(format))
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+            for (size_t i = 0; i < pixels; ++i)
+            {
+                const uint32_t t = *(sPtr++);
+                *(dPtr++) = XMVectorSet(table.linear[t & 0xff], table.linear[(t >> 8) & 0xff], table.linear[(t >> 16) & 0xff],
+                    table.unorm[t >> 24]);
+            }
+            return true;
+
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            for (size_t i = 0; i < pixels; ++i)
+            {
+                const uint32_t t = *(sPtr++);
+                *(dPtr++) = XMVectorSet(table.linear[(t >> 16) & 0xff], table.linear[(t >> 8) & 0xff], table.linear[t & 0xff],
+                    table.unorm[t >> 24]);
+            }
+            return true;
+
+        case DXGI_FORMAT_B8G8R8X8_UNORM:
+        case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+            for (size_t i = 0; i < pixels; ++i)
+            {
+                const uint32_t t = *(sPtr++);
+                *(dPtr++) = XMVectorSet(table.linear[(t >> 16) & 0xff], table.linear[(t >> 8) & 0xff], table.linear[t & 0xff], 1.f);
+            }
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    // Looks up a channel that holds an exact 8-bit UNORM value, as LoadScanline produces for 8-bit formats
+    inline bool LookupSRGB8(const SRGBTable& table, float& value) noexcept
+    {
+        const float index = value * 255.f + 0.5f;
+        if (!(index >= 0.f && index < 256.f))
+            return false;
+
+        const auto i = static_cast<size_t>(index);
+        if (table.unorm[i] != value)
+            return false;
+
+        value = table.linear[i];
+        return true;
+    }
+
+    // sRGB -> Linear RGB for a scanline already loaded from an 8-bit format. Pixels are looked up so
+    // they match LoadScanlineLinear, and any other value falls back to XMColorSRGBToRGB.
+    void ColorSRGBToRGB8(_Inout_updates_all_(count) XMVECTOR* pBuffer, size_t count) noexcept
+    {
+        const SRGBTable& table = GetSRGBTable();
+
+        XMVECTOR* ptr = pBuffer;
+        for (size_t i = 0; i < count; ++i, ++ptr)
+        {
+            XMFLOAT4A c;
+            XMStoreFloat4A(&c, *ptr);
+
+            if (LookupSRGB8(table, c.x) && LookupSRGB8(table, c.y) && LookupSRGB8(table, c.z))
+            {
+                *ptr = XMLoadFloat4A(&c);
+            }
+            else
+            {
+                *ptr = XMColorSRGBToRGB(*ptr);
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Linear RGB -> sRGB for formats with 8 bits per channel or fewer. The pow(x, 1/2.4)
+    // term is replaced by a rational fit in sqrt(x), which stays within 4e-6 of the exact
+    // curve (well under 1/100 of an 8-bit step) at a fraction of the cost.
+    //-------------------------------------------------------------------------------------
+    inline bool IsSRGBApproximate(DXGI_FORMAT format) noexcept
+    {
+        switch (static_cast<int>(format))
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_R8G8_UNORM:
+        case DXGI_FORMAT_R8_UNORM:
+        case DXGI_FORMAT_B5G6R5_UNORM:
+        case DXGI_FORMAT_B5G5R5A1_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8X8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+        case DXGI_FORMAT_B4G4R4A4_UNORM:
+        case WIN11_DXGI_FORMAT_A4B4G4R4_UNORM:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    inline XMVECTOR XM_CALLCONV ColorRGBToSRGB8(FXMVECTOR rgb) noexcept
+    {
+        static const XMVECTORF32 Cutoff = { { { 0.0031308f, 0.0031308f, 0.0031308f, 1.f } } };
+        static const XMVECTORF32 Linear = { { { 12.92f, 12.92f, 12.92f, 1.f } } };
+        static const XMVECTORF32 P0 = { { { -4.893864594e-02f, -4.893864594e-02f, -4.893864594e-02f, -4.893864594e-02f } } };
+        static const XMVECTORF32 P1 = { { { 1.174629809e+00f, 1.174629809e+00f, 1.174629809e+00f, 1.174629809e+00f } } };
+        static const XMVECTORF32 P2 = { { { 1.785264626e+01f, 1.785264626e+01f, 1.785264626e+01f, 1.785264626e+01f } } };
+        static const XMVECTORF32 P3 = { { { 1.795320181e+01f, 1.795320181e+01f, 1.795320181e+01f, 1.795320181e+01f } } };
+        static const XMVECTORF32 Q1 = { { { 1.447268639e+01f, 1.447268639e+01f, 1.447268639e+01f, 1.447268639e+01f } } };
+        static const XMVECTORF32 Q2 = { { { 2.057346389e+01f, 2.057346389e+01f, 2.057346389e+01f, 2.057346389e+01f } } };
+        static const XMVECTORF32 Q3 = { { { 8.855127637e-01f, 8.855127637e-01f, 8.855127637e-01f, 8.855127637e-01f } } };
+
+        const XMVECTOR V = XMVectorSaturate(rgb);
+        const XMVECTOR S = XMVectorSqrt(V);
+
+        XMVECTOR P = XMVectorMultiplyAdd(S, P3, P2);
+        P = XMVectorMultiplyAdd(P, S, P1);
+        P = XMVectorMultiplyAdd(P, S, P0);
+
+        XMVECTOR Q = XMVectorMultiplyAdd(S, Q3, Q2);
+        Q = XMVectorMultiplyAdd(Q, S, Q1);
+        Q = XMVectorMultiplyAdd(Q, S, g_XMOne);
+
+        const XMVECTOR V0 = XMVectorMultiply(V, Linear);
+        const XMVECTOR V1 = XMVectorDivide(P, Q);
+        const XMVECTOR select = XMVectorLess(V, Cutoff);
+        return XMVectorSelect(rgb, XMVectorSelect(V1, V0, select), g_XMSelect1110);
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Half <-> float rows using F16C, eight values per instruction. DirectXMath already
+    // uses F16C (or NEON on ARM64) when the build targets it, so this is only compiled for
+    // SSE2-only x86/x64 builds where it is selected at runtime. CPUs without F16C store
+    // halves with the same round-to-nearest-even, so the output does not depend on the CPU.
+    //-------------------------------------------------------------------------------------
+#ifdef USE_F16C_DISPATCH
+#if defined(__clang__) || defined(__GNUC__)
+#define F16C_TARGET __attribute__((target("avx,f16c")))
+#else
+#define F16C_TARGET
+#endif
+
+    bool DetectF16C() noexcept
+    {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int info[4] = {};
+        __cpuid(info, 0);
+        if (info[0] < 1)
+            return false;
+
+        __cpuid(info, 1);
+        const auto ecx = static_cast<uint32_t>(info[2]);
+    #else
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+    #endif
+
+        // F16C, AVX, and OSXSAVE
+        if ((ecx & 0x38000000) != 0x38000000)
+            return false;
+
+        // The OS must also save the YMM state
+    #if defined(_MSC_VER) && !defined(__clang__)
+        const uint64_t xcr0 = _xgetbv(0);
+    #else
+        uint32_t xcr0lo, xcr0hi;
+        __asm__ __volatile__("xgetbv" : "=a"(xcr0lo), "=d"(xcr0hi) : "c"(0));
+        const uint64_t xcr0 = (uint64_t(xcr0hi) << 32) | xcr0lo;
+    #endif
+        return (xcr0 & 0x6) == 0x6;
+    }
+
+    inline bool HasF16C() noexcept
+    {
+        static const bool s_f16c = DetectF16C();
+        return s_f16c;
+    }
+
+    F16C_TARGET void ConvertHalfToFloatF16C(
+        _Out_writes_(count) float* pOutput,
+        _In_reads_(count) const HALF* pInput,
+        size_t count) noexcept
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pInput + i));
+            _mm256_storeu_ps(pOutput + i, _mm256_cvtph_ps(h));
+        }
+
+        for (; i < count; ++i)
+        {
+            const __m128i h = _mm_cvtsi32_si128(static_cast<int>(pInput[i]));
+            pOutput[i] = _mm_cvtss_f32(_mm_cvtph_ps(h));
+        }
+
+        _mm256_zeroupper();
+    }
+
+    F16C_TARGET void ConvertFloatToHalfF16C(
+        _Out_writes_(count) HALF* pOutput,
+        _In_reads_(count) const float* pInput,
+        size_t count) noexcept
+    {
+        // Same operand order as XMVectorClamp so NaN passes through rather than clamping
+        const __m256 vmin = _mm256_set1_ps(-65504.f);
+        const __m256 vmax = _mm256_set1_ps(65504.f);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 v = _mm256_loadu_ps(pInput + i);
+            v = _mm256_min_ps(vmax, _mm256_max_ps(vmin, v));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pOutput + i), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+        }
+
+        for (; i < count; ++i)
+        {
+            __m128 v = _mm_set_ss(pInput[i]);
+            v = _mm_min_ss(_mm256_castps256_ps128(vmax), _mm_max_ss(_mm256_castps256_ps128(vmin), v));
+            pOutput[i] = static_cast<HALF>(_mm_cvtsi128_si32(_mm_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT)));
+        }
+
+        _mm256_zeroupper();
+    }
+
+    // Rounds every result to nearest even, denormals included, as F16C does. XMConvertFloatToHalf
+    // drops the bits shifted out of a denormal before it rounds, so it can differ by one in the last place.
+    inline HALF ConvertFloatToHalfRNE(float value) noexcept
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+
+        const uint32_t sign = (bits >> 16) & 0x8000u;
+        bits &= 0x7FFFFFFFu;
+
+        if (bits > 0x7F800000u)
+        {
+            // NaN stays a quiet NaN with the top of its payload
+            return static_cast<HALF>(sign | 0x7E00u | ((bits >> 13) & 0x3FFu));
+        }
+
+        if (bits >= 0x477FF000u)
+        {
+            // 65520 and up round to infinity
+            return static_cast<HALF>(sign | 0x7C00u);
+        }
+
+        if (bits >= 0x38800000u)
+        {
+            // Normal half: rebias the exponent, then round the 13 dropped bits
+            const uint32_t h = bits - 0x38000000u;
+            return static_cast<HALF>(sign | ((h + 0x0FFFu + ((h >> 13) & 1u)) >> 13));
+        }
+
+        if (bits <= 0x33000000u)
+        {
+            // At most half of the smallest denormal, which ties to zero
+            return static_cast<HALF>(sign);
+        }
+
+        // Denormal half: the significand is shifted right by 14 to 24 bits
+        const uint32_t m = 0x800000u | (bits & 0x7FFFFFu);
+        const uint32_t shift = 126u - (bits >> 23);
+        const uint32_t rest = m & ((1u << shift) - 1u);
+        const uint32_t halfway = 1u << (shift - 1u);
+
+        uint32_t h = m >> shift;
+        if (rest > halfway || (rest == halfway && (h & 1u)))
+            ++h;
+
+        return static_cast<HALF>(sign | h);
+    }
+
+    void ConvertFloatToHalfRow(
+        _Out_writes_(count) HALF* pOutput,
+        _In_reads_(count) const float* pInput,
+        size_t count) noexcept
+    {
+        if (HasF16C())
+        {
+            ConvertFloatToHalfF16C(pOutput, pInput, count);
+            return;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Clamped like ConvertFloatToHalfF16C, so NaN passes through
+            const float v = std::max<float>(std::min<float>(pInput[i], 65504.f), -65504.f);
+            pOutput[i] = ConvertFloatToHalfRNE(v);
+        }
+    }
+
+    // 1, 2, or 4 channel half scanlines, missing channels are filled from (0,0,0,1)
+    bool LoadScanlineHalfF16C(
+        _Out_writes_(count) XMVECTOR* pDestination,
+        size_t count,
+        _In_reads_bytes_(size) const void* pSource,
+        size_t size,
+        size_t channels) noexcept
+    {
+        const size_t stride = sizeof(HALF) * channels;
+        if (size < stride)
+            return false;
+
+        const size_t pixels = std::min(count, size / stride);
+        auto sPtr = static_cast<const HALF*>(pSource);
+
+        if (channels == 4)
+        {
+            ConvertHalfToFloatF16C(reinterpret_cast<float*>(pDestination), sPtr, pixels * 4);
+            return true;
+        }
+
+        float tmp[128];
+        const size_t chunk = 128 / channels;
+        for (size_t j = 0; j < pixels; j += chunk)
+        {
+            const size_t n = std::min(chunk, pixels - j);
+            ConvertHalfToFloatF16C(tmp, sPtr + j * channels, n * channels);
+
+            XMVECTOR* __restrict dPtr = pDestination + j;
+            if (channels == 2)
+            {
+                for (size_t k = 0; k < n; ++k)
+                    dPtr[k] = XMVectorSet(tmp[k * 2], tmp[k * 2 + 1], 0.f, 1.f);
+            }
+            else
+            {
+                for (size_t k = 0; k < n; ++k)
+                    dPtr[k] = XMVectorSet(tmp[k], 0.f, 0.f, 1.f);
+            }
+        }
+        return true;
+    }
+
+    bool StoreScanlineHalf(
+        _Out_writes_bytes_(size) void* pDestination,
+        size_t size,
+        _In_reads_(count) const XMVECTOR* pSource,
+        size_t count,
+        size_t channels) noexcept
+    {
+        const size_t stride = sizeof(HALF) * channels;
+        if (size < stride)
+            return false;
+
+        const size_t pixels = std::min(count, size / stride);
+        auto dPtr = static_cast<HALF*>(pDestination);
+
+        if (channels == 4)
+        {
+            ConvertFloatToHalfRow(dPtr, reinterpret_cast<const float*>(pSource), pixels * 4);
+            return true;
+        }
+
+        float tmp[128];
+        const size_t chunk = 128 / channels;
+        for (size_t j = 0; j < pixels; j += chunk)
+        {
+            const size_t n = std::min(chunk, pixels - j);
+
+            const XMVECTOR* __restrict sPtr = pSource + j;
+            if (channels == 2)
+            {
+                for (size_t k = 0; k < n; ++k)
+                {
+                    tmp[k * 2] = XMVectorGetX(sPtr[k]);
+                    tmp[k * 2 + 1] = XMVectorGetY(sPtr[k]);
+                }
+            }
+            else
+            {
+                for (size_t k = 0; k < n; ++k)
+                    tmp[k] = XMVectorGetX(sPtr[k]);
+            }
+
+            ConvertFloatToHalfRow(dPtr + j * channels, tmp, n * channels);
+        }
+        return true;
+    }
+#endif // USE_F16C_DISPATCH
+
+    //-------------------------------------------------------------------------------------
+    // SSE2 versions of the XMFLOAT3PK and XMFLOAT3SE load/store functions, four pixels
+    // at a time with the same results as DirectXMath for all non-NaN values
+    //-------------------------------------------------------------------------------------
+#ifdef _XM_SSE_INTRINSICS_
+    inline __m128i XM_CALLCONV SelectInt(__m128i a, __m128i b, __m128i control) noexcept
+    {
+        return _mm_or_si128(_mm_andnot_si128(control, a), _mm_and_si128(b, control));
+    }
+
+    // Float to an unsigned float with a 5-bit exponent and MBITS mantissa (XMStoreFloat3PK)
+    template<int MBITS>
+    inline __m128i XM_CALLCONV PackFloat5e(__m128 V) noexcept
+    {
+        constexpr int shift = 23 - MBITS;
+        constexpr int mask = (1 << (MBITS + 5)) - 1;
+        constexpr int maxBits = (0x1E << MBITS) | ((1 << MBITS) - 1);
+        constexpr int infBits = 0x1F << MBITS;
+        constexpr int tooSmall = (113 - MBITS) << 23;
+        constexpr int tooLarge = (0x8E << 23) | (((1 << MBITS) - 1) << shift);
+
+        const __m128i sign = _mm_srai_epi32(_mm_castps_si128(V), 31);
+        const __m128i I = _mm_and_si128(_mm_castps_si128(V), _mm_set1_epi32(0x7FFFFFFF));
+
+        // Denormal results shift (0x800000 | mantissa) right by (113 - exponent), which is V * 2^37 truncated
+        const __m128i denorm = _mm_cvttps_epi32(_mm_mul_ps(_mm_castsi128_ps(I), _mm_set1_ps(137438953472.f)));
+        const __m128i norm = _mm_add_epi32(I, _mm_set1_epi32(static_cast<int>(0xC8000000)));
+        __m128i R = SelectInt(norm, denorm, _mm_cmplt_epi32(I, _mm_set1_epi32(0x38800000)));
+
+        // Round to nearest even
+        const __m128i odd = _mm_and_si128(_mm_srli_epi32(R, shift), _mm_set1_epi32(1));
+        R = _mm_add_epi32(R, _mm_add_epi32(odd, _mm_set1_epi32((1 << (shift - 1)) - 1)));
+        R = _mm_and_si128(_mm_srli_epi32(R, shift), _mm_set1_epi32(mask));
+
+        // Out of range, in reverse order of precedence
+        R = SelectInt(R, _mm_set1_epi32(maxBits), _mm_cmpgt_epi32(I, _mm_set1_epi32(tooLarge)));
+        R = _mm_andnot_si128(_mm_or_si128(sign, _mm_cmplt_epi32(I, _mm_set1_epi32(tooSmall))), R);
+
+        // INF is clamped to 0 if negative, NAN is all ones
+        R = SelectInt(R, _mm_andnot_si128(sign, _mm_set1_epi32(infBits)), _mm_cmpeq_epi32(I, _mm_set1_epi32(0x7F800000)));
+        R = SelectInt(R, _mm_set1_epi32(mask), _mm_cmpgt_epi32(I, _mm_set1_epi32(0x7F800000)));
+        return R;
+    }
+
+    // Unsigned float with a 5-bit exponent and MBITS mantissa to float (XMLoadFloat3PK)
+    template<int MBITS>
+    inline __m128 XM_CALLCONV UnpackFloat5e(__m128i mantissa, __m128i exponent) noexcept
+    {
+        const __m128i bits = _mm_slli_epi32(mantissa, 23 - MBITS);
+        const __m128i norm = _mm_or_si128(_mm_slli_epi32(_mm_add_epi32(exponent, _mm_set1_epi32(112)), 23), bits);
+        const __m128i special = _mm_or_si128(_mm_set1_epi32(0x7F800000), bits);
+        const __m128 denorm = _mm_mul_ps(_mm_cvtepi32_ps(mantissa), _mm_castsi128_ps(_mm_set1_epi32((127 - 14 - MBITS) << 23)));
+
+        __m128i R = SelectInt(norm, special, _mm_cmpeq_epi32(exponent, _mm_set1_epi32(0x1F)));
+        R = SelectInt(R, _mm_castps_si128(denorm), _mm_cmpeq_epi32(exponent, _mm_setzero_si128()));
+        return _mm_castsi128_ps(R);
+    }
+
+    // lroundf for non-negative values
+    inline __m128i XM_CALLCONV RoundHalfUp(__m128 V) noexcept
+    {
+        const __m128i t = _mm_cvttps_epi32(V);
+        const __m128 frac = _mm_sub_ps(V, _mm_cvtepi32_ps(t));
+        return _mm_sub_epi32(t, _mm_castps_si128(_mm_cmpge_ps(frac, _mm_set1_ps(0.5f))));
+    }
+
+    bool LoadScanlineFloat3PK(
+        _Out_writes_(count) XMVECTOR* pDestination,
+        size_t count,
+        _In_reads_bytes_(size) const void* pSource,
+        size_t size) noexcept
+    {
+        if (size < sizeof(XMFLOAT3PK))
+            return false;
+
+        const size_t pixels = std::min(count, size / sizeof(XMFLOAT3PK));
+        auto sPtr = static_cast<const XMFLOAT3PK*>(pSource);
+
+        size_t i = 0;
+        for (; i + 4 <= pixels; i += 4)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sPtr + i));
+            const __m128i m6 = _mm_set1_epi32(0x3F);
+            const __m128i m5 = _mm_set1_epi32(0x1F);
+
+            __m128 x = UnpackFloat5e<6>(_mm_and_si128(v, m6), _mm_and_si128(_mm_srli_epi32(v, 6), m5));
+            __m128 y = UnpackFloat5e<6>(_mm_and_si128(_mm_srli_epi32(v, 11), m6), _mm_and_si128(_mm_srli_epi32(v, 17), m5));
+            __m128 z = UnpackFloat5e<5>(_mm_and_si128(_mm_srli_epi32(v, 22), m5), _mm_srli_epi32(v, 27));
+            __m128 w = g_XMOne;
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+
+            pDestination[i] = x;
+            pDestination[i + 1] = y;
+            pDestination[i + 2] = z;
+            pDestination[i + 3] = w;
+        }
+
+        for (; i < pixels; ++i)
+        {
+            pDestination[i] = XMVectorSelect(g_XMIdentityR3, XMLoadFloat3PK(sPtr + i), g_XMSelect1110);
+        }
+        return true;
+    }
+
+    bool StoreScanlineFloat3PK(
+        _Out_writes_bytes_(size) void* pDestination,
+        size_t size,
+        _In_reads_(count) const XMVECTOR* pSource,
+        size_t count) noexcept
+    {
+        if (size < sizeof(XMFLOAT3PK))
+            return false;
+
+        const size_t pixels = std::min(count, size / sizeof(XMFLOAT3PK));
+        auto dPtr = static_cast<XMFLOAT3PK*>(pDestination);
+
+        size_t i = 0;
+        for (; i + 4 <= pixels; i += 4)
+        {
+            __m128 x = pSource[i];
+            __m128 y = pSource[i + 1];
+            __m128 z = pSource[i + 2];
+            __m128 w = pSource[i + 3];
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+
+            __m128i v = PackFloat5e<6>(x);
+            v = _mm_or_si128(v, _mm_slli_epi32(PackFloat5e<6>(y), 11));
+            v = _mm_or_si128(v, _mm_slli_epi32(PackFloat5e<5>(z), 22));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dPtr + i), v);
+        }
+
+        for (; i < pixels; ++i)
+        {
+            XMStoreFloat3PK(dPtr + i, pSource[i]);
+        }
+        return true;
+    }
+
+    bool LoadScanlineFloat3SE(
+        _Out_writes_(count) XMVECTOR* pDestination,
+        size_t count,
+        _In_reads_bytes_(size) const void* pSource,
+        size_t size) noexcept
+    {
+        if (size < sizeof(XMFLOAT3SE))
+            return false;
+
+        const size_t pixels = std::min(count, size / sizeof(XMFLOAT3SE));
+        auto sPtr = static_cast<const XMFLOAT3SE*>(pSource);
+
+        size_t i = 0;
+        for (; i + 4 <= pixels; i += 4)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sPtr + i));
+            const __m128i m9 = _mm_set1_epi32(0x1FF);
+
+            // 2^(e - 15 - 9)
+            const __m128 scale = _mm_castsi128_ps(_mm_add_epi32(_mm_slli_epi32(_mm_srli_epi32(v, 27), 23), _mm_set1_epi32(0x33800000)));
+
+            __m128 x = _mm_mul_ps(scale, _mm_cvtepi32_ps(_mm_and_si128(v, m9)));
+            __m128 y = _mm_mul_ps(scale, _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 9), m9)));
+            __m128 z = _mm_mul_ps(scale, _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 18), m9)));
+            __m128 w = g_XMOne;
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+
+            pDestination[i] = x;
+            pDestination[i + 1] = y;
+            pDestination[i + 2] = z;
+            pDestination[i + 3] = w;
+        }
+
+        for (; i < pixels; ++i)
+        {
+            pDestination[i] = XMVectorSelect(g_XMIdentityR3, XMLoadFloat3SE(sPtr + i), g_XMSelect1110);
+        }
+        return true;
+    }
+
+    bool StoreScanlineFloat3SE(
+        _Out_writes_bytes_(size) void* pDestination,
+        size_t size,
+        _In_reads_(count) const XMVECTOR* pSource,
+        size_t count) noexcept
+    {
+        if (size < sizeof(XMFLOAT3SE))
+            return false;
+
+        const size_t pixels = std::min(count, size / sizeof(XMFLOAT3SE));
+        auto dPtr = static_cast<XMFLOAT3SE*>(pDestination);
+
+        const __m128 maxf9 = _mm_set1_ps(float(0x1FF << 7));
+        const __m128 minf9 = _mm_set1_ps(float(1.f / (1 << 16)));
+        const __m128i m9 = _mm_set1_epi32(0x1FF);
+
+        size_t i = 0;
+        for (; i + 4 <= pixels; i += 4)
+        {
+            __m128 x = pSource[i];
+            __m128 y = pSource[i + 1];
+            __m128 z = pSource[i + 2];
+            __m128 w = pSource[i + 3];
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+
+            // Negative and NaN go to zero
+            x = _mm_and_ps(_mm_cmpge_ps(x, _mm_setzero_ps()), _mm_min_ps(x, maxf9));
+            y = _mm_and_ps(_mm_cmpge_ps(y, _mm_setzero_ps()), _mm_min_ps(y, maxf9));
+            z = _mm_and_ps(_mm_cmpge_ps(z, _mm_setzero_ps()), _mm_min_ps(z, maxf9));
+
+            const __m128 maxColor = _mm_max_ps(_mm_max_ps(_mm_max_ps(x, y), z), minf9);
+
+            // Round up leaving 9 bits in fraction (including assumed 1)
+            const __m128i exp = _mm_srli_epi32(_mm_add_epi32(_mm_castps_si128(maxColor), _mm_set1_epi32(0x4000)), 23);
+            const __m128 scaleR = _mm_castsi128_ps(_mm_sub_epi32(_mm_set1_epi32(static_cast<int>(0x83000000)), _mm_slli_epi32(exp, 23)));
+
+            __m128i v = _mm_and_si128(RoundHalfUp(_mm_mul_ps(x, scaleR)), m9);
+            v = _mm_or_si128(v, _mm_slli_epi32(_mm_and_si128(RoundHalfUp(_mm_mul_ps(y, scaleR)), m9), 9));
+            v = _mm_or_si128(v, _mm_slli_epi32(_mm_and_si128(RoundHalfUp(_mm_mul_ps(z, scaleR)), m9), 18));
+            v = _mm_or_si128(v, _mm_slli_epi32(_mm_sub_epi32(exp, _mm_set1_epi32(0x6f)), 27));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dPtr + i), v);
+        }
+
+        for (; i < pixels; ++i)
+        {
+            StoreFloat3SE(dPtr + i, pSource[i]);
+        }
+        return true;
+    }
+#endif // _XM_SSE_INTRINSICS_
 }
 
 //-------------------------------------------------------------------------------------
@@ -816,6 +1487,10 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         LOAD_SCANLINE3(XMINT3, XMLoadSInt3, g_XMIdentityR3)
 
     case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    #ifdef USE_F16C_DISPATCH
+        if (HasF16C())
+            return LoadScanlineHalfF16C(dPtr, count, pSource, size, 4);
+    #endif
         LOAD_SCANLINE(XMHALF4, XMLoadHalf4)
 
     case DXGI_FORMAT_R16G16B16A16_UNORM:
@@ -902,7 +1577,11 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         LOAD_SCANLINE(XMUDEC4, XMLoadUDec4)
 
     case DXGI_FORMAT_R11G11B10_FLOAT:
+    #ifdef _XM_SSE_INTRINSICS_
+        return LoadScanlineFloat3PK(dPtr, count, pSource, size);
+    #else
         LOAD_SCANLINE3(XMFLOAT3PK, XMLoadFloat3PK, g_XMIdentityR3)
+    #endif
 
     case DXGI_FORMAT_R8G8B8A8_UNORM:
     case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
@@ -918,6 +1597,10 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         LOAD_SCANLINE(XMBYTE4, XMLoadByte4)
 
     case DXGI_FORMAT_R16G16_FLOAT:
+    #ifdef USE_F16C_DISPATCH
+        if (HasF16C())
+            return LoadScanlineHalfF16C(dPtr, count, pSource, size, 2);
+    #endif
         LOAD_SCANLINE2(XMHALF2, XMLoadHalf2, g_XMIdentityR3)
 
     case DXGI_FORMAT_R16G16_UNORM:
@@ -1036,6 +1719,10 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         LOAD_SCANLINE2(XMBYTE2, XMLoadByte2, g_XMIdentityR3)
 
     case DXGI_FORMAT_R16_FLOAT:
+    #ifdef USE_F16C_DISPATCH
+        if (HasF16C())
+            return LoadScanlineHalfF16C(dPtr, count, pSource, size, 1);
+    #endif
         if (size >= sizeof(HALF))
         {
             const HALF * __restrict sPtr = static_cast<const HALF*>(pSource);
@@ -1185,7 +1872,11 @@ _Use_decl_annotations_ bool DirectX::Internal::LoadScanline(
         return false;
 
     case DXGI_FORMAT_R9G9B9E5_SHAREDEXP:
+    #ifdef _XM_SSE_INTRINSICS_
+        return LoadScanlineFloat3SE(dPtr, count, pSource, size);
+    #else
         LOAD_SCANLINE3(XMFLOAT3SE, XMLoadFloat3SE, g_XMIdentityR3)
+    #endif
 
     case DXGI_FORMAT_R8G8_B8G8_UNORM:
         if (size >= sizeof(XMUBYTEN4))
@@ -1685,6 +2376,9 @@ bool DirectX::Internal::StoreScanline(
         STORE_SCANLINE(XMINT3, XMStoreSInt3)
 
     case DXGI_FORMAT_R16G16B16A16_FLOAT:
+    #ifdef USE_F16C_DISPATCH
+        return StoreScanlineHalf(pDestination, size, sPtr, count, 4);
+    #else
         if (size >= sizeof(XMHALF4))
         {
             XMHALF4* __restrict dPtr = static_cast<XMHALF4*>(pDestination);
@@ -1698,6 +2392,7 @@ bool DirectX::Internal::StoreScanline(
             return true;
         }
         return false;
+    #endif
 
     case DXGI_FORMAT_R16G16B16A16_UNORM:
         STORE_SCANLINE(XMUSHORTN4, XMStoreUShortN4)
@@ -1752,7 +2447,11 @@ bool DirectX::Internal::StoreScanline(
         STORE_SCANLINE(XMUDEC4, XMStoreUDec4)
 
     case DXGI_FORMAT_R11G11B10_FLOAT:
+    #ifdef _XM_SSE_INTRINSICS_
+        return StoreScanlineFloat3PK(pDestination, size, sPtr, count);
+    #else
         STORE_SCANLINE(XMFLOAT3PK, XMStoreFloat3PK)
+    #endif
 
     case DXGI_FORMAT_R8G8B8A8_UNORM:
     case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
@@ -1779,6 +2478,9 @@ bool DirectX::Internal::StoreScanline(
         STORE_SCANLINE(XMBYTE4, XMStoreByte4)
 
     case DXGI_FORMAT_R16G16_FLOAT:
+    #ifdef USE_F16C_DISPATCH
+        return StoreScanlineHalf(pDestination, size, sPtr, count, 2);
+    #else
         if (size >= sizeof(XMHALF2))
         {
             XMHALF2* __restrict dPtr = static_cast<XMHALF2*>(pDestination);
@@ -1792,6 +2494,7 @@ bool DirectX::Internal::StoreScanline(
             return true;
         }
         return false;
+    #endif
 
     case DXGI_FORMAT_R16G16_UNORM:
         STORE_SCANLINE(XMUSHORTN2, XMStoreUShortN2)
@@ -1878,6 +2581,9 @@ bool DirectX::Internal::StoreScanline(
         STORE_SCANLINE(XMBYTE2, XMStoreByte2)
 
     case DXGI_FORMAT_R16_FLOAT:
+    #ifdef USE_F16C_DISPATCH
+        return StoreScanlineHalf(pDestination, size, sPtr, count, 1);
+    #else
         if (size >= sizeof(HALF))
         {
             HALF * __restrict dPtr = static_cast<HALF*>(pDestination);
@@ -1891,6 +2597,7 @@ bool DirectX::Internal::StoreScanline(
             return true;
         }
         return false;
+    #endif
 
     case DXGI_FORMAT_D16_UNORM:
     case DXGI_FORMAT_R16_UNORM:
@@ -2053,7 +2760,11 @@ bool DirectX::Internal::StoreScanline(
         return false;
 
     case DXGI_FORMAT_R9G9B9E5_SHAREDEXP:
+    #ifdef _XM_SSE_INTRINSICS_
+        return StoreScanlineFloat3SE(pDestination, size, sPtr, count);
+    #else
         STORE_SCANLINE(XMFLOAT3SE, StoreFloat3SE)
+    #endif
 
     case DXGI_FORMAT_R8G8_B8G8_UNORM:
         if (size >= sizeof(XMUBYTEN4))
@@ -2858,9 +3569,19 @@ bool DirectX::Internal::StoreScanlineLinear(
         // To avoid the need for another temporary scanline buffer, we allow this function to overwrite the source buffer in-place
         // Given the intended usage in the filtering routines, this is not a problem.
         XMVECTOR* ptr = pSource;
-        for (size_t i = 0; i < count; ++i, ++ptr)
+        if (IsSRGBApproximate(format))
         {
-            *ptr = XMColorRGBToSRGB(*ptr);
+            for (size_t i = 0; i < count; ++i, ++ptr)
+            {
+                *ptr = ColorRGBToSRGB8(*ptr);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i, ++ptr)
+            {
+                *ptr = XMColorRGBToSRGB(*ptr);
+            }
         }
     }
 
@@ -2918,10 +3639,28 @@ bool DirectX::Internal::LoadScanlineLinear(
     case WIN11_DXGI_FORMAT_A4B4G4R4_UNORM:
         break;
 
-    default:
-        // can't treat A8, XR, Depth, SNORM, UINT, or SINT as sRGB
-        flags &= ~TEX_FILTER_SRGB;
-        break;
+    default:
+        // can't treat A8, XR, Depth, SNORM, UINT, or SINT as sRGB
+        flags &= ~TEX_FILTER_SRGB;
+        break;
+    }
+
+    if (flags & TEX_FILTER_SRGB_IN)
+    {
+        switch (static_cast<int>(format))
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8X8_UNORM:
+        case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+            // sRGB input processing (sRGB -> Linear RGB) by table lookup
+            return LoadScanlineSRGB8(pDestination, count, pSource, size, format);
+
+        default:
+            break;
+        }
     }
 
     if (LoadScanline(pDestination, count, pSource, size, format))
@@ -3167,7 +3906,11 @@ void DirectX::Internal::ConvertScanline(
     // sRGB input processing (sRGB -> Linear RGB)
     if (flags & TEX_FILTER_SRGB_IN)
     {
-        if (!(in->flags & CONVF_DEPTH) && ((in->flags & CONVF_FLOAT) || (in->flags & CONVF_UNORM)))
+        if (!(in->flags & CONVF_DEPTH) && (in->flags & CONVF_UNORM) && in->datasize == 8)
+        {
+            ColorSRGBToRGB8(pBuffer, count);
+        }
+        else if (!(in->flags & CONVF_DEPTH) && ((in->flags & CONVF_FLOAT) || (in->flags & CONVF_UNORM)))
         {
             XMVECTOR* ptr = pBuffer;
             for (size_t i = 0; i < count; ++i, ++ptr)
@@ -3843,9 +4586,19 @@ void DirectX::Internal::ConvertScanline(
         if (!(out->flags & CONVF_DEPTH) && ((out->flags & CONVF_FLOAT) || (out->flags & CONVF_UNORM)))
         {
             XMVECTOR* ptr = pBuffer;
-            for (size_t i = 0; i < count; ++i, ++ptr)
+            if (IsSRGBApproximate(outFormat))
             {
-                *ptr = XMColorRGBToSRGB(*ptr);
+                for (size_t i = 0; i < count; ++i, ++ptr)
+                {
+                    *ptr = ColorRGBToSRGB8(*ptr);
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < count; ++i, ++ptr)
+                {
+                    *ptr = XMColorRGBToSRGB(*ptr);
+                }
             }
         }
     }
@@ -4737,177 +5490,674 @@ namespace
         _In_ const WICPixelFormatGUID& targetGUID,
         _In_ TEX_FILTER_FLAGS filter,
         _In_ float threshold,
-        _In_ const Image& destImage)
+        _In_ const Image& destImage)
+    {
+    #ifndef _WIN32
+        UNREFERENCED_PARAMETER(srcImage);
+        UNREFERENCED_PARAMETER(pfGUID);
+        UNREFERENCED_PARAMETER(targetGUID);
+        UNREFERENCED_PARAMETER(filter);
+        UNREFERENCED_PARAMETER(threshold);
+        UNREFERENCED_PARAMETER(destImage);
+        return E_NOTIMPL;
+    #else
+        assert(srcImage.width == destImage.width);
+        assert(srcImage.height == destImage.height);
+
+        bool iswic2 = false;
+        auto pWIC = GetWICFactory(iswic2);
+        if (!pWIC)
+            return E_NOINTERFACE;
+
+        ComPtr<IWICFormatConverter> FC;
+        HRESULT hr = pWIC->CreateFormatConverter(FC.GetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        // Note that WIC conversion ignores the TEX_FILTER_SRGB_IN and TEX_FILTER_SRGB_OUT flags,
+        // but also always assumes UNORM <-> FLOAT conversions are changing color spaces sRGB <-> scRGB
+
+        BOOL canConvert = FALSE;
+        hr = FC->CanConvert(pfGUID, targetGUID, &canConvert);
+        if (FAILED(hr) || !canConvert)
+        {
+            // This case is not an issue for the subset of WIC formats that map directly to DXGI
+            return E_UNEXPECTED;
+        }
+
+        if (srcImage.rowPitch > UINT32_MAX || srcImage.slicePitch > UINT32_MAX
+            || destImage.rowPitch > UINT32_MAX || destImage.slicePitch > UINT32_MAX)
+            return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+        ComPtr<IWICBitmap> source;
+        hr = pWIC->CreateBitmapFromMemory(static_cast<UINT>(srcImage.width), static_cast<UINT>(srcImage.height), pfGUID,
+            static_cast<UINT>(srcImage.rowPitch), static_cast<UINT>(srcImage.slicePitch),
+            srcImage.pixels, source.GetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        hr = FC->Initialize(source.Get(), targetGUID, GetWICDither(filter), nullptr,
+            static_cast<double>(threshold) * 100.0, WICBitmapPaletteTypeMedianCut);
+        if (FAILED(hr))
+            return hr;
+
+        hr = FC->CopyPixels(nullptr, static_cast<UINT>(destImage.rowPitch), static_cast<UINT>(destImage.slicePitch), destImage.pixels);
+        if (FAILED(hr))
+            return hr;
+
+        return S_OK;
+    #endif // WIN32
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Direct conversion kernels for common format pairs
+    //-------------------------------------------------------------------------------------
+    struct ChannelLayout
+    {
+        uint32_t shift[4];
+        uint32_t bits[4];
+    };
+
+    bool GetChannelLayout(_In_ DXGI_FORMAT format, _Out_ ChannelLayout& layout) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+            layout = { { 0, 8, 16, 24 }, { 8, 8, 8, 8 } };
+            return true;
+
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8X8_UNORM:
+        case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+            layout = { { 16, 8, 0, 24 }, { 8, 8, 8, 8 } };
+            return true;
+
+        case DXGI_FORMAT_R10G10B10A2_UNORM:
+            layout = { { 0, 10, 20, 30 }, { 10, 10, 10, 2 } };
+            return true;
+
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            layout = { { 0, 16, 32, 48 }, { 16, 16, 16, 16 } };
+            return true;
+
+        default:
+            layout = {};
+            return false;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Builds per-channel lookup tables for a 32-bit source format by running every source
+    // channel value through the generic LoadScanline/ConvertScanline/StoreScanline path.
+    // Each destination channel depends only on the matching source channel for these
+    // formats, so a converted pixel is the OR of its four table entries.
+    //-------------------------------------------------------------------------------------
+    template<typename TDest>
+    std::unique_ptr<TDest[]> BuildConvertTable(DXGI_FORMAT srcFormat, DXGI_FORMAT destFormat) noexcept
+    {
+        ChannelLayout src, dest;
+        if (!GetChannelLayout(srcFormat, src) || !GetChannelLayout(destFormat, dest))
+            return nullptr;
+
+        size_t total = 0;
+        size_t maxEntries = 0;
+        for (size_t c = 0; c < 4; ++c)
+        {
+            const size_t entries = size_t(1) << src.bits[c];
+            total += entries;
+            maxEntries = std::max(maxEntries, entries);
+        }
+
+        std::unique_ptr<TDest[]> table(new (std::nothrow) TDest[total]);
+        std::unique_ptr<uint32_t[]> pixels(new (std::nothrow) uint32_t[maxEntries]);
+        auto scanline = make_AlignedArrayXMVECTOR(maxEntries);
+        if (!table || !pixels || !scanline)
+            return nullptr;
+
+        TDest* ptr = table.get();
+        for (size_t c = 0; c < 4; ++c)
+        {
+            const size_t entries = size_t(1) << src.bits[c];
+            for (size_t i = 0; i < entries; ++i)
+            {
+                pixels[i] = static_cast<uint32_t>(i) << src.shift[c];
+            }
+
+            if (!LoadScanline(scanline.get(), entries, pixels.get(), entries * sizeof(uint32_t), srcFormat))
+                return nullptr;
+
+            ConvertScanline(scanline.get(), entries, destFormat, srcFormat, TEX_FILTER_DEFAULT);
+
+            if (!StoreScanline(ptr, entries * sizeof(TDest), destFormat, scanline.get(), entries, 0.f))
+                return nullptr;
+
+            const auto mask = static_cast<TDest>(((uint64_t(1) << dest.bits[c]) - 1) << dest.shift[c]);
+            for (size_t i = 0; i < entries; ++i)
+            {
+                ptr[i] &= mask;
+            }
+
+            ptr += entries;
+        }
+
+        return table;
+    }
+
+    template<typename TDest, DXGI_FORMAT srcFormat, DXGI_FORMAT destFormat>
+    const TDest* GetConvertTable() noexcept
+    {
+        static const std::unique_ptr<TDest[]> s_table = BuildConvertTable<TDest>(srcFormat, destFormat);
+        return s_table.get();
+    }
+
+    template<typename TDest, DXGI_FORMAT srcFormat, DXGI_FORMAT destFormat>
+    bool PrepareTableKernel() noexcept
+    {
+        return GetConvertTable<TDest, srcFormat, destFormat>() != nullptr;
+    }
+
+    template<typename TDest, DXGI_FORMAT srcFormat, DXGI_FORMAT destFormat>
+    void ConvertTableKernel(void* pDestination, const void* pSource, size_t count) noexcept
+    {
+        ChannelLayout src;
+        std::ignore = GetChannelLayout(srcFormat, src);
+
+        const TDest* lutR = GetConvertTable<TDest, srcFormat, destFormat>();
+        const TDest* lutG = lutR + (size_t(1) << src.bits[0]);
+        const TDest* lutB = lutG + (size_t(1) << src.bits[1]);
+        const TDest* lutA = lutB + (size_t(1) << src.bits[2]);
+
+        const uint32_t maskR = (1u << src.bits[0]) - 1;
+        const uint32_t maskG = (1u << src.bits[1]) - 1;
+        const uint32_t maskB = (1u << src.bits[2]) - 1;
+        const uint32_t maskA = (1u << src.bits[3]) - 1;
+
+        const uint32_t * __restrict sPtr = static_cast<const uint32_t*>(pSource);
+        TDest * __restrict dPtr = static_cast<TDest*>(pDestination);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint32_t t = *(sPtr++);
+            *(dPtr++) = static_cast<TDest>(lutR[(t >> src.shift[0]) & maskR]
+                | lutG[(t >> src.shift[1]) & maskG]
+                | lutB[(t >> src.shift[2]) & maskB]
+                | lutA[(t >> src.shift[3]) & maskA]);
+        }
+    }
+
+    //-------------------------------------------------------------------------------------
+    // FLOAT16 sources have too many values for a table, so these fuse the generic
+    // load/convert/store steps into a single pass without the XMVECTOR scanline
+    //-------------------------------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable : 4127)
+
+    template<DXGI_FORMAT destFormat>
+    void ConvertHalfKernel(void* pDestination, const void* pSource, size_t count) noexcept
+    {
+        const XMHALF4 * __restrict sPtr = static_cast<const XMHALF4*>(pSource);
+
+        if (destFormat == DXGI_FORMAT_R10G10B10A2_UNORM)
+        {
+            XMUDECN4 * __restrict dPtr = static_cast<XMUDECN4*>(pDestination);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const XMVECTOR v = XMVectorSaturate(XMLoadHalf4(sPtr++));
+                XMStoreUDecN4(dPtr++, v);
+            }
+            return;
+        }
+
+        const bool srgb = IsSRGB(destFormat);
+
+        XMUBYTEN4 * __restrict dPtr = static_cast<XMUBYTEN4*>(pDestination);
+        for (size_t i = 0; i < count; ++i)
+        {
+            XMVECTOR v = XMVectorSaturate(XMLoadHalf4(sPtr++));
+            if (srgb)
+            {
+                v = ColorRGBToSRGB8(v);
+            }
+
+            switch (destFormat)
+            {
+            case DXGI_FORMAT_B8G8R8A8_UNORM:
+            case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+                v = XMVectorSwizzle<2, 1, 0, 3>(v);
+                break;
+
+            case DXGI_FORMAT_B8G8R8X8_UNORM:
+            case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+                v = XMVectorPermute<2, 1, 0, 7>(v, g_XMIdentityR3);
+                break;
+
+            default:
+                break;
+            }
+
+            v = XMVectorAdd(v, g_8BitBias);
+            XMStoreUByteN4(dPtr++, v);
+        }
+    }
+
+#pragma warning(pop)
+
+    struct ConvertKernel
+    {
+        DXGI_FORMAT srcFormat;
+        DXGI_FORMAT destFormat;
+        bool (*pfnPrepare)();
+        void (*pfnConvert)(void* pDestination, const void* pSource, size_t count);
+    };
+
+#define TABLE_KERNEL(type, src, dest) { src, dest, PrepareTableKernel<type, src, dest>, ConvertTableKernel<type, src, dest> }
+#define HALF_KERNEL(dest) { DXGI_FORMAT_R16G16B16A16_FLOAT, dest, nullptr, ConvertHalfKernel<dest> }
+
+    const ConvertKernel g_ConvertKernels[] =
+    {
+        // 8-bit swizzles
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_B8G8R8A8_UNORM),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_B8G8R8X8_UNORM),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_FORMAT_B8G8R8X8_UNORM),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8X8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8X8_UNORM, DXGI_FORMAT_B8G8R8A8_UNORM),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DXGI_FORMAT_B8G8R8X8_UNORM_SRGB),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, DXGI_FORMAT_B8G8R8X8_UNORM_SRGB),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8X8_UNORM_SRGB, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8X8_UNORM_SRGB, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB),
+
+        // 8-bit sRGB <-> linear
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DXGI_FORMAT_R8G8B8A8_UNORM),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DXGI_FORMAT_B8G8R8A8_UNORM),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, DXGI_FORMAT_R8G8B8A8_UNORM),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, DXGI_FORMAT_B8G8R8A8_UNORM),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8X8_UNORM, DXGI_FORMAT_B8G8R8X8_UNORM_SRGB),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8X8_UNORM_SRGB, DXGI_FORMAT_B8G8R8X8_UNORM),
+
+        // UNORM -> FLOAT16
+        TABLE_KERNEL(uint64_t, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R16G16B16A16_FLOAT),
+        TABLE_KERNEL(uint64_t, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DXGI_FORMAT_R16G16B16A16_FLOAT),
+        TABLE_KERNEL(uint64_t, DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_FORMAT_R16G16B16A16_FLOAT),
+        TABLE_KERNEL(uint64_t, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, DXGI_FORMAT_R16G16B16A16_FLOAT),
+        TABLE_KERNEL(uint64_t, DXGI_FORMAT_B8G8R8X8_UNORM, DXGI_FORMAT_R16G16B16A16_FLOAT),
+        TABLE_KERNEL(uint64_t, DXGI_FORMAT_B8G8R8X8_UNORM_SRGB, DXGI_FORMAT_R16G16B16A16_FLOAT),
+        TABLE_KERNEL(uint64_t, DXGI_FORMAT_R10G10B10A2_UNORM, DXGI_FORMAT_R16G16B16A16_FLOAT),
+
+        // FLOAT16 -> UNORM
+        HALF_KERNEL(DXGI_FORMAT_R8G8B8A8_UNORM),
+        HALF_KERNEL(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB),
+        HALF_KERNEL(DXGI_FORMAT_B8G8R8A8_UNORM),
+        HALF_KERNEL(DXGI_FORMAT_B8G8R8A8_UNORM_SRGB),
+        HALF_KERNEL(DXGI_FORMAT_B8G8R8X8_UNORM),
+        HALF_KERNEL(DXGI_FORMAT_B8G8R8X8_UNORM_SRGB),
+        HALF_KERNEL(DXGI_FORMAT_R10G10B10A2_UNORM),
+
+        // 10:10:10:2 <-> 8-bit
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_R10G10B10A2_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_R10G10B10A2_UNORM, DXGI_FORMAT_B8G8R8A8_UNORM),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R10G10B10A2_UNORM),
+        TABLE_KERNEL(uint32_t, DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_FORMAT_R10G10B10A2_UNORM),
+    };
+
+#undef TABLE_KERNEL
+#undef HALF_KERNEL
+
+    //-------------------------------------------------------------------------------------
+    // Returns a direct kernel for the format pair, or nullptr to use the generic path
+    //-------------------------------------------------------------------------------------
+    const ConvertKernel* GetConvertKernel(
+        _In_ DXGI_FORMAT srcFormat,
+        _In_ DXGI_FORMAT destFormat,
+        _In_ TEX_FILTER_FLAGS filter) noexcept
+    {
+        // The kernels implement the default conversion only
+        if (filter & (TEX_FILTER_DITHER | TEX_FILTER_DITHER_DIFFUSION | TEX_FILTER_SRGB | TEX_FILTER_FLOAT_X2BIAS))
+            return nullptr;
+
+        for (const auto& kernel : g_ConvertKernels)
+        {
+            if (kernel.srcFormat == srcFormat && kernel.destFormat == destFormat)
+            {
+                if (kernel.pfnPrepare && !kernel.pfnPrepare())
+                    return nullptr;
+
+                return &kernel;
+            }
+        }
+
+        return nullptr;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Convert the source images (not using WIC)
+    //-------------------------------------------------------------------------------------
+    struct ConvertItem
+    {
+        const Image* srcImage;
+        const Image* destImage;
+        size_t z;
+    };
+
+    // Rows are handed out to threads in bands of about this many pixels
+    constexpr size_t CONVERT_BAND_PIXELS = 16384;
+
+    inline size_t GetBandRows(const Image& image) noexcept
+    {
+        return std::max<size_t>(1, CONVERT_BAND_PIXELS / std::max<size_t>(1, image.width));
+    }
+
+    // Conversion is only spread across threads when the caller asks for it with TEX_FILTER_PARALLEL
+    inline size_t GetConvertThreads(const ConvertOptions& options) noexcept
+    {
+        return (options.filter & TEX_FILTER_PARALLEL) ? options.maxThreads : 1;
+    }
+
+    // Scanline for the conversion tasks, kept by each thread so it is allocated once rather than per band
+    XMVECTOR* GetThreadScanline(size_t count) noexcept
+    {
+        thread_local ScopedAlignedArrayXMVECTOR s_scanline;
+        thread_local size_t s_count = 0;
+
+        if (count > s_count)
+        {
+            s_scanline = make_AlignedArrayXMVECTOR(count);
+            s_count = (s_scanline) ? count : 0;
+        }
+
+        return s_scanline.get();
+    }
+
+    HRESULT ConvertRows(
+        const ConvertItem& item,
+        _In_ TEX_FILTER_FLAGS filter,
+        _In_ float threshold,
+        _In_opt_ const ConvertKernel* kernel,
+        size_t y,
+        size_t rows) noexcept
+    {
+        const Image& srcImage = *item.srcImage;
+        const Image& destImage = *item.destImage;
+
+        const uint8_t *pSrc = srcImage.pixels + y * srcImage.rowPitch;
+        uint8_t *pDest = destImage.pixels + y * destImage.rowPitch;
+
+        const size_t width = srcImage.width;
+
+        if (kernel)
+        {
+            // Direct conversion kernel
+            for (size_t h = 0; h < rows; ++h)
+            {
+                kernel->pfnConvert(pDest, pSrc, width);
+
+                pSrc += srcImage.rowPitch;
+                pDest += destImage.rowPitch;
+            }
+        }
+        else
+        {
+            assert(!(filter & TEX_FILTER_DITHER_DIFFUSION));
+
+            XMVECTOR* scanline = GetThreadScanline(width);
+            if (!scanline)
+                return E_OUTOFMEMORY;
+
+            for (size_t h = y; h < y + rows; ++h)
+            {
+                if (!LoadScanline(scanline, width, pSrc, srcImage.rowPitch, srcImage.format))
+                    return E_FAIL;
+
+                ConvertScanline(scanline, width, destImage.format, srcImage.format, filter);
+
+                if (filter & TEX_FILTER_DITHER)
+                {
+                    // Ordered dithering
+                    if (!StoreScanlineDither(pDest, destImage.rowPitch, destImage.format, scanline, width, threshold, h, item.z, nullptr))
+                        return E_FAIL;
+                }
+                else
+                {
+                    // No dithering
+                    if (!StoreScanline(pDest, destImage.rowPitch, destImage.format, scanline, width, threshold))
+                        return E_FAIL;
+                }
+
+                pSrc += srcImage.rowPitch;
+                pDest += destImage.rowPitch;
+            }
+        }
+
+        return S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Error diffusion dithering (aka Floyd-Steinberg dithering) has to store the rows in
+    // order, and the serpentine scan means a row needs all of the row above it, but loading
+    // and converting rows does not depend on the error. Each step stores one band of rows
+    // on one thread while the other threads load and convert the next band, so the result
+    // is identical to converting one row at a time.
+    //-------------------------------------------------------------------------------------
+    HRESULT ConvertDiffusion(
+        const ConvertItem& item,
+        _In_ TEX_FILTER_FLAGS filter,
+        _In_ float threshold,
+        size_t maxThreads,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
     {
-    #ifndef _WIN32
-        UNREFERENCED_PARAMETER(srcImage);
-        UNREFERENCED_PARAMETER(pfGUID);
-        UNREFERENCED_PARAMETER(targetGUID);
-        UNREFERENCED_PARAMETER(filter);
-        UNREFERENCED_PARAMETER(threshold);
-        UNREFERENCED_PARAMETER(destImage);
-        return E_NOTIMPL;
-    #else
-        assert(srcImage.width == destImage.width);
-        assert(srcImage.height == destImage.height);
+        const Image& srcImage = *item.srcImage;
+        const Image& destImage = *item.destImage;
 
-        bool iswic2 = false;
-        auto pWIC = GetWICFactory(iswic2);
-        if (!pWIC)
-            return E_NOINTERFACE;
+        const size_t width = srcImage.width;
+        const size_t height = srcImage.height;
+        const size_t bandRows = GetBandRows(srcImage);
+        const size_t nBands = (height + bandRows - 1) / bandRows;
 
-        ComPtr<IWICFormatConverter> FC;
-        HRESULT hr = pWIC->CreateFormatConverter(FC.GetAddressOf());
-        if (FAILED(hr))
-            return hr;
+        const size_t bandSize = bandRows * width;
+        auto buffer = make_AlignedArrayXMVECTOR(uint64_t(bandSize) * 2 + width + 2);
+        if (!buffer)
+            return E_OUTOFMEMORY;
 
-        // Note that WIC conversion ignores the TEX_FILTER_SRGB_IN and TEX_FILTER_SRGB_OUT flags,
-        // but also always assumes UNORM <-> FLOAT conversions are changing color spaces sRGB <-> scRGB
+        XMVECTOR* bands[2] = { buffer.get(), buffer.get() + bandSize };
 
-        BOOL canConvert = FALSE;
-        hr = FC->CanConvert(pfGUID, targetGUID, &canConvert);
-        if (FAILED(hr) || !canConvert)
+        XMVECTOR* pDiffusionErrors = buffer.get() + bandSize * 2;
+        memset(pDiffusionErrors, 0, sizeof(XMVECTOR)*(width + 2));
+
+        std::atomic<bool> fail(false);
+
+        // Step n converts band n and stores band n - 1
+        for (size_t band = 0; band <= nBands; ++band)
         {
-            // This case is not an issue for the subset of WIC formats that map directly to DXGI
-            return E_UNEXPECTED;
-        }
+            const size_t convertStart = band * bandRows;
+            const size_t convertRows = (band < nBands) ? std::min(bandRows, height - convertStart) : 0;
 
-        if (srcImage.rowPitch > UINT32_MAX || srcImage.slicePitch > UINT32_MAX
-            || destImage.rowPitch > UINT32_MAX || destImage.slicePitch > UINT32_MAX)
-            return HRESULT_E_ARITHMETIC_OVERFLOW;
+            const size_t storeStart = (band > 0) ? convertStart - bandRows : 0;
+            const size_t storeRows = (band > 0) ? std::min(bandRows, height - storeStart) : 0;
 
-        ComPtr<IWICBitmap> source;
-        hr = pWIC->CreateBitmapFromMemory(static_cast<UINT>(srcImage.width), static_cast<UINT>(srcImage.height), pfGUID,
-            static_cast<UINT>(srcImage.rowPitch), static_cast<UINT>(srcImage.slicePitch),
-            srcImage.pixels, source.GetAddressOf());
-        if (FAILED(hr))
-            return hr;
+            if (statusCallback)
+            {
+                if (!statusCallback(storeStart, height))
+                {
+                    return E_ABORT;
+                }
+            }
 
-        hr = FC->Initialize(source.Get(), targetGUID, GetWICDither(filter), nullptr,
-            static_cast<double>(threshold) * 100.0, WICBitmapPaletteTypeMedianCut);
-        if (FAILED(hr))
-            return hr;
+            XMVECTOR* pConvert = bands[band & 1];
+            XMVECTOR* pStore = bands[(band + 1) & 1];
 
-        hr = FC->CopyPixels(nullptr, static_cast<UINT>(destImage.rowPitch), static_cast<UINT>(destImage.slicePitch), destImage.pixels);
-        if (FAILED(hr))
-            return hr;
+            ParallelFor(convertRows + 1, maxThreads, [&](size_t task)
+            {
+                if (!task)
+                {
+                    for (size_t row = 0; row < storeRows; ++row)
+                    {
+                        const size_t h = storeStart + row;
+                        if (!StoreScanlineDither(destImage.pixels + h * destImage.rowPitch, destImage.rowPitch, destImage.format,
+                            pStore + row * width, width, threshold, h, item.z, pDiffusionErrors))
+                        {
+                            fail = true;
+                            return;
+                        }
+                    }
+                    return;
+                }
+
+                const size_t h = convertStart + task - 1;
+                XMVECTOR* scanline = pConvert + (task - 1) * width;
+
+                if (!LoadScanline(scanline, width, srcImage.pixels + h * srcImage.rowPitch, srcImage.rowPitch, srcImage.format))
+                {
+                    fail = true;
+                    return;
+                }
+
+                ConvertScanline(scanline, width, destImage.format, srcImage.format, filter);
+            });
+
+            if (fail)
+                return E_FAIL;
+        }
 
         return S_OK;
-    #endif // WIN32
     }
 
     //-------------------------------------------------------------------------------------
-    // Convert the source image (not using WIC)
+    // Bands of rows from all the images are spread across threads. Progress is reported
+    // in rows for a single image and in completed images otherwise, from whichever thread
+    // finished the band; a lock keeps the callback from being entered by two at once.
     //-------------------------------------------------------------------------------------
     HRESULT ConvertCustom(
-        _In_ const Image& srcImage,
+        _In_reads_(nitems) const ConvertItem* items,
+        size_t nitems,
         _In_ TEX_FILTER_FLAGS filter,
-        _In_ const Image& destImage,
         _In_ float threshold,
-        size_t z,
+        size_t maxThreads,
         const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
     {
-        assert(srcImage.width == destImage.width);
-        assert(srcImage.height == destImage.height);
+        if (!items || !nitems)
+            return E_INVALIDARG;
 
-        const uint8_t *pSrc = srcImage.pixels;
-        uint8_t *pDest = destImage.pixels;
-        if (!pSrc || !pDest)
-            return E_POINTER;
+        for (size_t index = 0; index < nitems; ++index)
+        {
+            assert(items[index].srcImage->width == items[index].destImage->width);
+            assert(items[index].srcImage->height == items[index].destImage->height);
 
-        size_t width = srcImage.width;
+            if (!items[index].srcImage->pixels || !items[index].destImage->pixels)
+                return E_POINTER;
+        }
 
         if (filter & TEX_FILTER_DITHER_DIFFUSION)
         {
-            // Error diffusion dithering (aka Floyd-Steinberg dithering)
-            auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 2 + 2);
-            if (!scanline)
-                return E_OUTOFMEMORY;
-
-            XMVECTOR* pDiffusionErrors = scanline.get() + width;
-            memset(pDiffusionErrors, 0, sizeof(XMVECTOR)*(width + 2));
-
-            for (size_t h = 0; h < srcImage.height; ++h)
+            // Images are dithered one at a time, each with its own pipeline of bands
+            for (size_t index = 0; index < nitems; ++index)
             {
-                if (statusCallback)
+                const HRESULT hr = ConvertDiffusion(items[index], filter, threshold, maxThreads,
+                    (nitems == 1) ? statusCallback : nullptr);
+                if (FAILED(hr))
+                    return hr;
+
+                if (statusCallback && nitems > 1)
                 {
-                    if (!statusCallback(h, srcImage.height))
+                    if (!statusCallback(index + 1, nitems))
                     {
                         return E_ABORT;
                     }
                 }
+            }
 
-                if (!LoadScanline(scanline.get(), width, pSrc, srcImage.rowPitch, srcImage.format))
-                    return E_FAIL;
+            return S_OK;
+        }
 
-                ConvertScanline(scanline.get(), width, destImage.format, srcImage.format, filter);
+        const ConvertKernel* kernel = GetConvertKernel(items[0].srcImage->format, items[0].destImage->format, filter);
 
-                if (!StoreScanlineDither(pDest, destImage.rowPitch, destImage.format, scanline.get(), width, threshold, h, z, pDiffusionErrors))
-                    return E_FAIL;
+        std::unique_ptr<size_t[]> bandStart(new (std::nothrow) size_t[nitems + 1]);
+        std::unique_ptr<std::atomic<size_t>[]> pending(new (std::nothrow) std::atomic<size_t>[nitems]);
+        if (!bandStart || !pending)
+            return E_OUTOFMEMORY;
 
-                pSrc += srcImage.rowPitch;
-                pDest += destImage.rowPitch;
-            }
-        }
-        else
+        size_t nBands = 0;
+        for (size_t index = 0; index < nitems; ++index)
         {
-            auto scanline = make_AlignedArrayXMVECTOR(width);
-            if (!scanline)
-                return E_OUTOFMEMORY;
+            const size_t bandRows = GetBandRows(*items[index].srcImage);
+            const size_t bands = (items[index].srcImage->height + bandRows - 1) / bandRows;
+
+            bandStart[index] = nBands;
+            pending[index] = bands;
+            nBands += bands;
+        }
+        bandStart[nitems] = nBands;
 
-            if (filter & TEX_FILTER_DITHER)
+        std::atomic<bool> fail(false);
+        std::atomic<bool> oom(false);
+
+        std::atomic<size_t> rowsDone(0);
+        std::atomic<size_t> imagesDone(0);
+        std::atomic<bool> abort(false);
+        std::mutex statusMutex;
+
+        ParallelFor(nBands, maxThreads, [&](size_t nband)
+        {
+            if (abort)
             {
-                // Ordered dithering
-                for (size_t h = 0; h < srcImage.height; ++h)
-                {
-                    if (statusCallback)
-                    {
-                        if (!statusCallback(h, srcImage.height))
-                        {
-                            return E_ABORT;
-                        }
-                    }
+                // Short circuit the work item if an abort is requested.
+                return;
+            }
 
-                    if (!LoadScanline(scanline.get(), width, pSrc, srcImage.rowPitch, srcImage.format))
-                        return E_FAIL;
+            const size_t* it = std::upper_bound(bandStart.get(), bandStart.get() + nitems + 1, nband);
+            const size_t index = size_t(it - bandStart.get()) - 1;
+            const ConvertItem& item = items[index];
 
-                    ConvertScanline(scanline.get(), width, destImage.format, srcImage.format, filter);
+            const size_t bandRows = GetBandRows(*item.srcImage);
+            const size_t y = (nband - bandStart[index]) * bandRows;
+            const size_t rows = std::min(bandRows, item.srcImage->height - y);
 
-                    if (!StoreScanlineDither(pDest, destImage.rowPitch, destImage.format, scanline.get(), width, threshold, h, z, nullptr))
-                        return E_FAIL;
+            const HRESULT hr = ConvertRows(item, filter, threshold, kernel, y, rows);
+            if (hr == E_OUTOFMEMORY)
+            {
+                oom = true;
+            }
+            else if (FAILED(hr))
+            {
+                fail = true;
+            }
 
-                    pSrc += srcImage.rowPitch;
-                    pDest += destImage.rowPitch;
-                }
+            rowsDone += rows;
+            if (--pending[index] == 0)
+            {
+                ++imagesDone;
             }
-            else
+
+            if (statusCallback)
             {
-                // No dithering
-                for (size_t h = 0; h < srcImage.height; ++h)
+                // The counts are read under the lock so the callback never sees them go backwards
+                std::lock_guard<std::mutex> lock(statusMutex);
+                if (!abort)
                 {
-                    if (statusCallback)
+                    const bool keepGoing = (nitems == 1)
+                        ? statusCallback(rowsDone, item.srcImage->height)
+                        : statusCallback(imagesDone, nitems);
+                    if (!keepGoing)
                     {
-                        if (!statusCallback(h, srcImage.height))
-                        {
-                            return E_ABORT;
-                        }
+                        abort = true;
                     }
-
-                    if (!LoadScanline(scanline.get(), width, pSrc, srcImage.rowPitch, srcImage.format))
-                        return E_FAIL;
-
-                    ConvertScanline(scanline.get(), width, destImage.format, srcImage.format, filter);
-
-                    if (!StoreScanline(pDest, destImage.rowPitch, destImage.format, scanline.get(), width, threshold))
-                        return E_FAIL;
-
-                    pSrc += srcImage.rowPitch;
-                    pDest += destImage.rowPitch;
                 }
             }
-        }
+        });
 
-        return S_OK;
+        if (abort)
+            return E_ABORT;
+
+        if (oom)
+            return E_OUTOFMEMORY;
+
+        return (fail) ? E_FAIL : S_OK;
     }
 
     //-------------------------------------------------------------------------------------
@@ -5152,7 +6402,8 @@ HRESULT DirectX::ConvertEx(
     }
     else
     {
-        hr = ConvertCustom(srcImage, options.filter, *rimage, options.threshold, 0, statusCallback);
+        const ConvertItem item = { &srcImage, rimage, 0 };
+        hr = ConvertCustom(&item, 1, options.filter, options.threshold, GetConvertThreads(options), statusCallback);
     }
 
     if (FAILED(hr))
@@ -5263,119 +6514,38 @@ HRESULT DirectX::ConvertEx(
     WICPixelFormatGUID pfGUID, targetGUID;
     const bool usewic = !metadata.IsPMAlpha() && UseWICConversion(options.filter, metadata.format, format, pfGUID, targetGUID);
 
+    std::unique_ptr<ConvertItem[]> items(new (std::nothrow) ConvertItem[nimages]);
+    if (!items)
+    {
+        result.Release();
+        return E_OUTOFMEMORY;
+    }
+
+    size_t nitems = 0;
     switch (metadata.dimension)
     {
     case TEX_DIMENSION_TEXTURE1D:
     case TEX_DIMENSION_TEXTURE2D:
-        for (size_t index = 0; index < nimages; ++index)
+        for (; nitems < nimages; ++nitems)
         {
-            const Image& src = srcImages[index];
-            if (src.format != metadata.format)
-            {
-                result.Release();
-                return E_FAIL;
-            }
-
-            if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
-            {
-                result.Release();
-                return E_FAIL;
-            }
-
-            const Image& dst = dest[index];
-            assert(dst.format == format);
-
-            if (src.width != dst.width || src.height != dst.height)
-            {
-                result.Release();
-                return E_FAIL;
-            }
-
-            if (usewic)
-            {
-                hr = ConvertUsingWIC(src, pfGUID, targetGUID, options.filter, options.threshold, dst);
-            }
-            else
-            {
-                hr = ConvertCustom(src, options.filter, dst, options.threshold, 0, nullptr);
-            }
-
-            if (FAILED(hr))
-            {
-                result.Release();
-                return hr;
-            }
-
-            if (statusCallback)
-            {
-                if (!statusCallback(index, nimages))
-                {
-                    result.Release();
-                    return E_ABORT;
-                }
-            }
+            items[nitems] = { &srcImages[nitems], &dest[nitems], 0 };
         }
         break;
 
     case TEX_DIMENSION_TEXTURE3D:
         {
-            size_t index = 0;
             size_t d = metadata.depth;
             for (size_t level = 0; level < metadata.mipLevels; ++level)
             {
-                for (size_t slice = 0; slice < d; ++slice, ++index)
+                for (size_t slice = 0; slice < d; ++slice, ++nitems)
                 {
-                    if (index >= nimages)
-                    {
-                        result.Release();
-                        return E_FAIL;
-                    }
-
-                    const Image& src = srcImages[index];
-                    if (src.format != metadata.format)
-                    {
-                        result.Release();
-                        return E_FAIL;
-                    }
-
-                    if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
-                    {
-                        result.Release();
-                        return E_FAIL;
-                    }
-
-                    const Image& dst = dest[index];
-                    assert(dst.format == format);
-
-                    if (src.width != dst.width || src.height != dst.height)
+                    if (nitems >= nimages)
                     {
                         result.Release();
                         return E_FAIL;
                     }
 
-                    if (usewic)
-                    {
-                        hr = ConvertUsingWIC(src, pfGUID, targetGUID, options.filter, options.threshold, dst);
-                    }
-                    else
-                    {
-                        hr = ConvertCustom(src, options.filter, dst, options.threshold, slice, nullptr);
-                    }
-
-                    if (FAILED(hr))
-                    {
-                        result.Release();
-                        return hr;
-                    }
-
-                    if (statusCallback)
-                    {
-                        if (!statusCallback(index, nimages))
-                        {
-                            result.Release();
-                            return E_ABORT;
-                        }
-                    }
+                    items[nitems] = { &srcImages[nitems], &dest[nitems], slice };
                 }
 
                 if (d > 1)
@@ -5389,6 +6559,62 @@ HRESULT DirectX::ConvertEx(
         return E_FAIL;
     }
 
+    for (size_t index = 0; index < nitems; ++index)
+    {
+        const Image& src = *items[index].srcImage;
+        if (src.format != metadata.format)
+        {
+            result.Release();
+            return E_FAIL;
+        }
+
+        if ((src.width > UINT32_MAX) || (src.height > UINT32_MAX))
+        {
+            result.Release();
+            return E_FAIL;
+        }
+
+        const Image& dst = *items[index].destImage;
+        assert(dst.format == format);
+
+        if (src.width != dst.width || src.height != dst.height)
+        {
+            result.Release();
+            return E_FAIL;
+        }
+    }
+
+    if (usewic)
+    {
+        for (size_t index = 0; index < nitems; ++index)
+        {
+            hr = ConvertUsingWIC(*items[index].srcImage, pfGUID, targetGUID, options.filter, options.threshold, *items[index].destImage);
+            if (FAILED(hr))
+            {
+                result.Release();
+                return hr;
+            }
+
+            if (statusCallback)
+            {
+                if (!statusCallback(index, nimages))
+                {
+                    result.Release();
+                    return E_ABORT;
+                }
+            }
+        }
+    }
+    else
+    {
+        hr = ConvertCustom(items.get(), nitems, options.filter, options.threshold, GetConvertThreads(options), statusCallback);
+        if (FAILED(hr))
+        {
+            result.Release();
+            return hr;
+        }
+    }
+
     if (statusCallback)
     {
         if (!statusCallback(nimages, nimages))
@@ -142,20 +142,23 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cctype>
+#include <condition_variable>
 #include <cstdlib>
 #include <ctime>
 #include <cstring>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <new>
+#include <thread>
 #include <tuple>
 
 #ifndef _WIN32
 #include <fstream>
 #include <filesystem>
-#include <thread>
 #endif
 
 #define _XM_NO_XMVECTOR_OVERLOADS_
@@ -454,5 +457,11 @@ namespace DirectX
             _Inout_ const Image* img) noexcept;
     #endif
 
+        //---------------------------------------------------------------------------------
+        // Multithreading
+        void __cdecl ParallelFor(_In_ size_t count, _In_ size_t maxThreads,
+            _In_ const std::function<void __cdecl(size_t)>& task) noexcept;
+            // Runs task(0) through task(count - 1) on the task scheduler, returning once all have finished
+
     } // namespace Internal
 } // namespace DirectX
@@ -123,6 +123,132 @@ namespace
 
 #define _aligned_free free
 #endif
+
+    //-------------------------------------------------------------------------------------
+    // Built-in task scheduler
+    //-------------------------------------------------------------------------------------
+    class TaskPool
+    {
+    public:
+        static TaskPool& Get()
+        {
+            // Never destroyed, as joining threads while a DLL unloads can deadlock
+            static TaskPool* s_pool = new TaskPool;
+            return *s_pool;
+        }
+
+        // Items are handed out one at a time from a shared counter, so a thread that finishes
+        // early keeps taking work until none is left
+        void Run(size_t count, size_t maxThreads, const std::function<void __cdecl(size_t)>& task) noexcept
+        {
+            Job job;
+            job.task = &task;
+            job.count = count;
+            job.next = 0;
+            job.helpers = (maxThreads > 0) ? std::min(maxThreads - 1, m_threads) : m_threads;
+            job.active = 0;
+
+            bool posted = false;
+            if (job.helpers > 0)
+            {
+                try
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_jobs.push_back(&job);
+                    posted = true;
+                }
+                catch (...)
+                {
+                }
+            }
+
+            if (!posted)
+            {
+                Drain(job);
+                return;
+            }
+
+            m_wake.notify_all();
+            Drain(job);
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobs.erase(std::find(m_jobs.begin(), m_jobs.end(), &job));
+            m_idle.wait(lock, [&job]() { return job.active == 0; });
+        }
+
+    private:
+        struct Job
+        {
+            const std::function<void __cdecl(size_t)>* task;
+            size_t count;
+            std::atomic<size_t> next;
+            size_t helpers;     // Pool threads that may still join the caller
+            size_t active;      // Pool threads currently working on it
+        };
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_idle;
+        std::vector<Job*> m_jobs;
+        size_t m_threads;
+
+        TaskPool() noexcept : m_threads(0)
+        {
+            try
+            {
+                const unsigned int ncores = std::thread::hardware_concurrency();
+                for (unsigned int i = 1; i < ncores; ++i)
+                {
+                    std::thread(&TaskPool::Worker, this).detach();
+                    ++m_threads;
+                }
+            }
+            catch (...)
+            {
+                // Run with however many threads were started
+            }
+        }
+
+        static void Drain(Job& job)
+        {
+            for (size_t index = job.next++; index < job.count; index = job.next++)
+            {
+                (*job.task)(index);
+            }
+        }
+
+        Job* FindJob() const noexcept
+        {
+            for (auto job : m_jobs)
+            {
+                if (job->helpers > 0 && job->next < job->count)
+                    return job;
+            }
+            return nullptr;
+        }
+
+        void Worker()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;)
+            {
+                Job* job = nullptr;
+                m_wake.wait(lock, [&]() { job = FindJob(); return job != nullptr; });
+
+                --job->helpers;
+                ++job->active;
+                lock.unlock();
+
+                Drain(*job);
+
+                lock.lock();
+                if (--job->active == 0)
+                    m_idle.notify_all();
+            }
+        }
+    };
+
+    TaskParallelFor g_TaskScheduler;
 }
 
 
@@ -331,6 +457,54 @@ void DirectX::SetWICFactory(_In_opt_ IWICImagingFactory* pWIC) noexcept
 #endif // WIN32
 
 
+//=====================================================================================
+// Multithreading
+//=====================================================================================
+
+//-------------------------------------------------------------------------------------
+// Optional replacement for the built-in task scheduler
+//-------------------------------------------------------------------------------------
+void DirectX::SetTaskScheduler(_In_ TaskParallelFor parallelFor) noexcept
+{
+    g_TaskScheduler = std::move(parallelFor);
+}
+
+
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void DirectX::Internal::ParallelFor(size_t count, size_t maxThreads, const std::function<void __cdecl(size_t)>& task) noexcept
+{
+    if (count > 1 && maxThreads != 1)
+    {
+        if (g_TaskScheduler)
+        {
+            g_TaskScheduler(count, maxThreads, task);
+            return;
+        }
+
+        TaskPool* pool = nullptr;
+        try
+        {
+            pool = &TaskPool::Get();
+        }
+        catch (...)
+        {
+        }
+
+        if (pool)
+        {
+            pool->Run(count, maxThreads, task);
+            return;
+        }
+    }
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        task(index);
+    }
+}
+
+
 //=====================================================================================
 // DXGI Format Utilities
 //=====================================================================================
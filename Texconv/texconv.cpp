@@ -842,16 +842,14 @@ namespace
             L"   -nologo             suppress copyright message\n"
             L"   --timing            display elapsed processing time\n"
             L"\n"
-        #ifdef _OPENMP
-            L"   --single-proc       Do not use multi-threaded compression\n"
-        #endif
+            L"   --single-proc       Do not use multi-threaded compression, decompression or conversion\n"
             L"   -gpu <adapter>      Select GPU for DirectCompute-based codecs (0 is default)\n"
             L"   -nogpu              Do not use DirectCompute-based codecs\n"
             L"\n"
             L"   -bc <options>, --block-compress <options>\n"
             L"                       Sets options for BC compression\n"
             L"                       options must be one or more of\n"
-            L"                          d, u, q, x\n"
+            L"                          d, u, q, x, f, b, h, w\n"
             L"   -aw <weight>, --alpha-weight <weight>\n"
             L"                       BC7 GPU compressor weighting for alpha error metric\n"
             L"                       (defaults to 1.0)\n"
@@ -1768,6 +1766,30 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                         found = true;
                     }
 
+                    if (wcschr(pValue, L'h'))
+                    {
+                        dwCompress |= TEX_COMPRESS_BC6H_QUICK;
+                        found = true;
+                    }
+
+                    if (wcschr(pValue, L'f'))
+                    {
+                        dwCompress |= TEX_COMPRESS_EFFORT_FAST;
+                        found = true;
+                    }
+
+                    if (wcschr(pValue, L'b'))
+                    {
+                        dwCompress |= TEX_COMPRESS_EFFORT_BEST;
+                        found = true;
+                    }
+
+                    if (wcschr(pValue, L'w'))
+                    {
+                        dwCompress |= TEX_COMPRESS_BC7_BATCH;
+                        found = true;
+                    }
+
                     if ((dwCompress & (TEX_COMPRESS_BC7_QUICK | TEX_COMPRESS_BC7_USE_3SUBSETS)) == (TEX_COMPRESS_BC7_QUICK | TEX_COMPRESS_BC7_USE_3SUBSETS))
                     {
                         wprintf(L"Can't use -bc x (max) and -bc q (quick) at same time\n\n");
@@ -1775,9 +1797,16 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                         return 1;
                     }
 
+                    if ((dwCompress & (TEX_COMPRESS_EFFORT_FAST | TEX_COMPRESS_EFFORT_BEST)) == (TEX_COMPRESS_EFFORT_FAST | TEX_COMPRESS_EFFORT_BEST))
+                    {
+                        wprintf(L"Can't use -bc f (fast) and -bc b (best) at same time\n\n");
+                        PrintUsage();
+                        return 1;
+                    }
+
                     if (!found)
                     {
-                        wprintf(L"Invalid value specified for -bc (%ls), missing d, u, q, or x\n\n", pValue);
+                        wprintf(L"Invalid value specified for -bc (%ls), missing d, u, q, x, f, b, h, or w\n\n", pValue);
                         return 1;
                     }
                 }
@@ -2364,7 +2393,13 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 return 1;
             }
 
-            hr = Decompress(img, nimg, info, DXGI_FORMAT_UNKNOWN /* picks good default */, *timage);
+            DecompressOptions decompressOptions = {};
+            if (!(dwOptions & (UINT64_C(1) << OPT_FORCE_SINGLEPROC)))
+            {
+                decompressOptions.flags |= TEX_DECOMPRESS_PARALLEL;
+            }
+
+            hr = DecompressEx(img, nimg, info, DXGI_FORMAT_UNKNOWN /* picks good default */, decompressOptions, *timage);
             if (FAILED(hr))
             {
                 wprintf(L" FAILED [decompress] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
@@ -2622,8 +2657,16 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                     return 1;
                 }
 
-                hr = Convert(image->GetImages(), image->GetImageCount(), image->GetMetadata(), DXGI_FORMAT_R16G16B16A16_FLOAT,
-                    dwFilter | dwFilterOpts | dwSRGB | dwConvert, alphaThreshold, *timage);
+                ConvertOptions convertOptions = {};
+                convertOptions.filter = dwFilter | dwFilterOpts | dwSRGB | dwConvert;
+                if (!(dwOptions & (UINT64_C(1) << OPT_FORCE_SINGLEPROC)))
+                {
+                    convertOptions.filter |= TEX_FILTER_PARALLEL;
+                }
+                convertOptions.threshold = alphaThreshold;
+
+                hr = ConvertEx(image->GetImages(), image->GetImageCount(), image->GetMetadata(), DXGI_FORMAT_R16G16B16A16_FLOAT,
+                    convertOptions, *timage);
                 if (FAILED(hr))
                 {
                     wprintf(L" FAILED [convert] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
@@ -3023,8 +3066,16 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 return 1;
             }
 
-            hr = Convert(image->GetImages(), image->GetImageCount(), image->GetMetadata(), tformat,
-                dwFilter | dwFilterOpts | dwSRGB | dwConvert, alphaThreshold, *timage);
+            ConvertOptions convertOptions = {};
+            convertOptions.filter = dwFilter | dwFilterOpts | dwSRGB | dwConvert;
+            if (!(dwOptions & (UINT64_C(1) << OPT_FORCE_SINGLEPROC)))
+            {
+                convertOptions.filter |= TEX_FILTER_PARALLEL;
+            }
+            convertOptions.threshold = alphaThreshold;
+
+            hr = ConvertEx(image->GetImages(), image->GetImageCount(), image->GetMetadata(), tformat,
+                convertOptions, *timage);
             if (FAILED(hr))
             {
                 wprintf(L" FAILED [convert] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
@@ -3607,12 +3658,10 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                     }
 
                     TEX_COMPRESS_FLAGS cflags = dwCompress;
-                #ifdef _OPENMP
                     if (!(dwOptions & (UINT64_C(1) << OPT_FORCE_SINGLEPROC)))
                     {
                         cflags |= TEX_COMPRESS_PARALLEL;
                     }
-                #endif
 
                     if ((img->width % 4) != 0 || (img->height % 4) != 0)
                     {
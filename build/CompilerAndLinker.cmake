@@ -146,9 +146,8 @@ elseif(CMAKE_CXX_COMPILER_ID MATCHES "MSVC")
     endif()
 
     if((CMAKE_CXX_COMPILER_VERSION VERSION_GREATER_EQUAL 19.11)
-       AND (OpenMP_CXX_FOUND
-           OR (XBOX_CONSOLE_TARGET STREQUAL "durango")))
-      # OpenMP in MSVC is not compatible with /permissive- unless you disable two-phase lookup
+       AND (XBOX_CONSOLE_TARGET STREQUAL "durango"))
+      # Xbox One XDK builds are not compatible with /permissive- unless you disable two-phase lookup
       list(APPEND COMPILER_SWITCHES /Zc:twoPhase-)
     endif()
 